@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace levin {
+
+// Keeps disk usage and the non-empty file count of a directory tree current
+// from filesystem events, so nothing has to walk the tree periodically.
+// Linux only (recursive inotify); start() fails elsewhere and callers keep
+// measuring usage themselves.
+class DataDirTracker {
+public:
+    DataDirTracker();
+    ~DataDirTracker();
+
+    // Non-copyable
+    DataDirTracker(const DataDirTracker&) = delete;
+    DataDirTracker& operator=(const DataDirTracker&) = delete;
+
+    // Start watching every directory under `root` and measuring it, on a
+    // background thread. Returns -1 if `root` isn't a directory or inotify
+    // isn't available. The tracker is active once the measurement is
+    // adopted by poll(); if watches run out it never becomes active.
+    int start(const std::string& root);
+    void stop();
+    bool active() const;     // totals are known and being kept current
+    bool measuring() const;  // a measurement is running in the background
+
+    // Apply pending events, and adopt a finished measurement. Non-blocking;
+    // call from the tick. If the event queue overflowed, or a whole subtree
+    // moved, the tree is measured again in the background, reporting the
+    // last known totals meanwhile.
+    void poll();
+
+    uint64_t usage() const;    // allocated bytes of regular files
+    int file_count() const;    // non-empty regular files
+    uint64_t rescans() const;  // full measurements after start()
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace levin
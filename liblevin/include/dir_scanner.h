@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace levin {
+
+struct ScannedFile {
+    std::string path;     // root + "/" + relative path
+    uint64_t size;        // apparent size
+    uint64_t allocated;   // blocks actually used (st_blocks * 512)
+};
+
+// Totals for one entry directly under the root: a torrent's directory, or
+// a single-file torrent's file
+struct TopLevelUsage {
+    std::string name;
+    uint64_t usage = 0;
+    int file_count = 0;
+    int64_t newest_mtime = 0;  // seconds since the epoch, newest file below it
+};
+
+struct DirScan {
+    uint64_t usage = 0;   // allocated bytes of all regular files, like `du -s`
+    int file_count = 0;   // non-empty regular files
+    std::vector<ScannedFile> files;  // every regular file, if asked for
+    std::vector<TopLevelUsage> top_level;  // sorted by name, if asked for
+};
+
+struct ScanOptions {
+    bool collect_files = false;
+    bool by_top_level = false;
+    // Threads walking subdirectories in parallel; 0 = pick from the core count
+    int threads = 0;
+};
+
+// Walk `root` in one pass and total its regular files. Symlinks and special
+// files are skipped and never followed. On Linux, directories are read in
+// large getdents64 batches and entries are stat'ed relative to their
+// directory fd, so no per-entry path is built unless files are collected.
+// A missing or unreadable root gives an empty result; unreadable subtrees
+// are skipped.
+DirScan scan_directory(const std::string& root, const ScanOptions& options = {});
+
+// Size and allocation of a single regular file, not following symlinks.
+// Returns false if `path` is not a regular file.
+bool scan_file(const std::string& path, ScannedFile& out);
+
+} // namespace levin
@@ -3,9 +3,23 @@
 #include <cstdint>
 #include <string>
 #include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
 
 namespace levin {
 
+class EvictionIndex;
+struct ScannedFile;
+
+// Free the blocks under [offset, offset + length) of a file, keeping its
+// size; the range reads back as zeros. False where the platform or
+// filesystem can't (only Linux fallocate(FALLOC_FL_PUNCH_HOLE) is used).
+bool punch_hole(const std::string& path, uint64_t offset, uint64_t length);
+// Whether holes can be punched in files under `dir`, found by punching one
+// in a scratch file there. vfat and exFAT, common on SD cards, can't.
+bool can_punch_holes(const std::string& dir);
+
 struct DiskBudgetResult {
     uint64_t budget_bytes;
     uint64_t deficit_bytes;
@@ -14,6 +28,17 @@ struct DiskBudgetResult {
 
 class DiskManager {
 public:
+    // Takes over deleting some of the given files (see
+    // ITorrentSession::evict_files) and returns the rest; nullopt aborts
+    // the deletion, with these files left alone
+    using FileEvictor =
+        std::function<std::optional<std::vector<std::string>>(const std::vector<std::string>&)>;
+    // Frees about `bytes` of a large file without deleting it (see
+    // ITorrentSession::shrink_file); returns the bytes freed, or 0
+    using FileShrinker = std::function<uint64_t(const std::string& path, uint64_t bytes)>;
+    // Told the bytes and non-empty files freed by each step of a deletion
+    using FreedCallback = std::function<void(uint64_t bytes, int files)>;
+
     // Constructor for budget calculation
     // min_free_bytes: absolute minimum free space to preserve
     // min_free_pct: minimum free space as fraction of total (e.g. 0.05 = 5%)
@@ -27,15 +52,49 @@ public:
                                uint64_t current_usage) const;
 
     // Delete files from directory until at least deficit_bytes are freed.
-    // Returns actual bytes freed.
-    uint64_t delete_to_free(const std::filesystem::path& dir, uint64_t deficit_bytes);
+    // Returns actual bytes freed (allocated blocks, as disk usage counts
+    // them); files_removed, if given, receives how many non-empty files went.
+    // With an eviction index, the least valuable top-level entries go first;
+    // files not covered by it are deleted in random order. Files the
+    // evictor takes count as freed when it takes them; if it aborts, what
+    // was freed so far is returned.
+    uint64_t delete_to_free(const std::filesystem::path& dir, uint64_t deficit_bytes,
+                            int* files_removed = nullptr);
+
+    // Ranking of the directory's top-level entries. Not owned; null deletes
+    // in random order. Fully deleted entries are erased from it.
+    void set_eviction_index(EvictionIndex* index) { eviction_index_ = index; }
+
+    // Hands each batch of files to delete to `evictor` first; without one,
+    // files are unlinked directly
+    void set_evictor(FileEvictor evictor) { evictor_ = std::move(evictor); }
+
+    // Asked first about files far larger than what is left to free, so one
+    // huge file doesn't go whole for a small deficit
+    void set_shrinker(FileShrinker shrinker) { shrinker_ = std::move(shrinker); }
+
+    // Reports progress while delete_to_free() runs, after every shrunk file
+    // and batch of deleted ones
+    void set_freed_callback(FreedCallback on_freed) { on_freed_ = std::move(on_freed); }
 
 private:
     uint64_t min_free_bytes_;
     double min_free_pct_;
     uint64_t max_storage_;
+    EvictionIndex* eviction_index_ = nullptr;
+    FileEvictor evictor_;
+    FileShrinker shrinker_;
+    FreedCallback on_freed_;
 
     static constexpr uint64_t HYSTERESIS = 50ULL * 1024 * 1024; // 50 MB
+    // Files at least this large, and RATIO times what is left to free, are
+    // shrunk rather than deleted
+    static constexpr uint64_t PARTIAL_EVICTION_MIN = 64ULL * 1024 * 1024;
+    static constexpr uint64_t PARTIAL_EVICTION_RATIO = 4;
+
+    enum class Deleted { ALL, SOME, ABORTED };
+    Deleted delete_files(std::vector<ScannedFile>& files, uint64_t target, uint64_t& freed,
+                         int* files_removed) const;
 };
 
 } // namespace levin
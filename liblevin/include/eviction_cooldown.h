@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace levin {
+
+/**
+ * Keeps levin from refilling space an eviction has just freed. When free
+ * space hovers near the limit, a file downloaded now is evicted at the
+ * next check and the bandwidth is wasted.
+ *
+ * After an eviction starts, the budget is capped for a window so usage
+ * stays a margin below the usage that triggered it. An eviction that comes
+ * before the previous window has been quiet for a whole window is churn: it
+ * doubles both window and margin, up to MAX_DOUBLINGS times. An eviction
+ * after a quiet spell starts over from the base window.
+ */
+class EvictionCooldown {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    static constexpr uint64_t BASE_MARGIN = 50ULL * 1024 * 1024;  // 50 MB
+    static constexpr int MAX_DOUBLINGS = 3;
+
+    // A zero window turns the cooldown off
+    explicit EvictionCooldown(std::chrono::seconds window = std::chrono::seconds(0));
+
+    // An eviction started at `now` with levin using `usage` bytes
+    void record_eviction(uint64_t usage, TimePoint now);
+
+    // `budget`, capped while cooling down so that downloading it all leaves
+    // usage under the ceiling
+    uint64_t cap_budget(uint64_t budget, uint64_t usage, TimePoint now) const;
+
+    bool active(TimePoint now) const;
+    // Time left in the current window, rounded up
+    std::chrono::seconds remaining(TimePoint now) const;
+    // Window and margin of the latest eviction
+    std::chrono::seconds window() const;
+    uint64_t margin() const;
+    uint64_t ceiling() const { return ceiling_; }
+    int churn_streak() const { return streak_; }
+
+private:
+    std::chrono::seconds base_;
+    bool evicted_ = false;
+    int streak_ = 0;       // consecutive evictions that counted as churn
+    TimePoint until_{};    // end of the current window
+    uint64_t ceiling_ = 0;
+};
+
+} // namespace levin
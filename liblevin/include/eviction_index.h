@@ -0,0 +1,90 @@
+#pragma once
+
+#include "dir_scanner.h"
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace levin {
+
+/**
+ * Ranks the top-level entries of the data directory (one per torrent) by
+ * how much they are worth keeping, so eviction takes the least valuable
+ * first instead of a random file.
+ *
+ * An entry's value is its recent demand divided by (1 + other seeds in its
+ * swarm). Demand counts uploads seen by the seeding scheduler, one unit per
+ * BYTES_PER_UNIT, plus one unit for the entry's last write or download. Every
+ * unit halves in weight each HALF_LIFE_SECS. So an entry nobody asked for
+ * ages by the time since it was last touched, and a well-seeded one is
+ * cheap to lose.
+ *
+ * Every entry decays at the same rate, so the order never changes as time
+ * passes; only updates move entries. Demand is kept as log2 of its weight
+ * at a fixed epoch, and the ranking is a sorted set: updates are O(log n)
+ * and the next victim is the first element.
+ *
+ * Thread-safe: the session feeds it from the tick thread while eviction
+ * reads it from its worker.
+ */
+class EvictionIndex {
+public:
+    static constexpr double HALF_LIFE_SECS = 7 * 24 * 3600.0;
+    static constexpr double BYTES_PER_UNIT = 1024.0 * 1024.0;
+
+    // Record `units` of demand for `name` at `now` (unix seconds), creating
+    // the entry if needed
+    void add_demand(const std::string& name, double units, int64_t now);
+
+    // Make sure `name` is ranked; a new entry counts as last touched at
+    // `last_access`. Existing entries are left alone.
+    void touch(const std::string& name, int64_t last_access);
+
+    // Seeds in the entry's swarm besides us. Ignored for unknown entries.
+    void set_swarm_seeds(const std::string& name, int seeds);
+
+    // Make the index hold exactly the entries a walk of the data directory
+    // found: new ones are touched at their newest mtime, missing ones dropped
+    void sync(const std::vector<TopLevelUsage>& entries);
+
+    void erase(const std::string& name);
+
+    // Entry most worth evicting, if any
+    std::optional<std::string> next_victim() const;
+
+    // log2 of the entry's value at `now`; -infinity if unknown
+    double value(const std::string& name, int64_t now) const;
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    // Load from file. Returns false if it doesn't exist or is corrupt.
+    bool load(const std::string& path);
+
+    // Save to file (via a temporary and rename). Returns false on write error.
+    bool save(const std::string& path) const;
+
+private:
+    struct Entry {
+        double log_demand = 0;  // log2 of the demand's weight at the epoch
+        int seeds = 0;
+    };
+
+    static double rank_key(const Entry& e);
+    // Callers hold mutex_
+    void put(const std::string& name, const Entry& e);
+    void touch_locked(const std::string& name, int64_t last_access);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::set<std::pair<double, std::string>> ranking_;  // (rank_key, name), least valuable first
+};
+
+} // namespace levin
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace levin {
+
+/**
+ * Runs deletions off the tick thread. Jobs run one at a time, in the order
+ * they were posted, on a single thread; the space they free is added up as
+ * they go and collected by the tick with take_freed().
+ *
+ * Jobs must not touch the torrent session, which belongs to the tick
+ * thread. call_on_owner() hands such a call over: the job blocks until the
+ * tick runs it from run_owner_calls().
+ */
+class EvictionWorker {
+public:
+    struct Freed {
+        uint64_t bytes = 0;  // allocated blocks, as disk usage counts them
+        int files = 0;
+    };
+
+    EvictionWorker() = default;
+    ~EvictionWorker();
+    EvictionWorker(const EvictionWorker&) = delete;
+    EvictionWorker& operator=(const EvictionWorker&) = delete;
+
+    void start();
+    // Finish the queued jobs and join. Owner calls made from now on are
+    // declined, since the tick may no longer be running them.
+    void stop();
+    bool running() const;
+
+    // Queue a job. Without a running worker it runs right away, on the
+    // caller's thread.
+    void post(std::function<void()> job);
+
+    // True while jobs are queued or running
+    bool busy() const;
+
+    // From jobs: count space freed so far
+    void add_freed(uint64_t bytes, int files);
+    // Space freed since the last call
+    Freed take_freed();
+
+    // From jobs: run `fn` on the tick thread and wait for its result. Empty
+    // if the worker is stopping. Called from the tick thread itself (a job
+    // run by post() without a worker), `fn` runs directly.
+    template <typename F>
+    auto call_on_owner(F fn) -> std::optional<decltype(fn())>;
+
+    // From the tick thread: run the calls jobs are waiting on
+    void run_owner_calls();
+
+private:
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::deque<std::function<void(bool run)>> owner_calls_;  // run = false declines
+    Freed freed_;
+    int active_ = 0;  // jobs taken off the queue and not finished
+    bool running_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+template <typename F>
+auto EvictionWorker::call_on_owner(F fn) -> std::optional<decltype(fn())> {
+    using R = decltype(fn());
+    std::promise<std::optional<R>> promise;
+    std::future<std::optional<R>> result = promise.get_future();
+    bool direct;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        direct = !running_ || std::this_thread::get_id() != thread_.get_id();
+        if (!direct) {
+            if (stopping_) return std::nullopt;
+            // Both outlive the call: this job waits for it below
+            owner_calls_.push_back([&promise, &fn](bool run) {
+                if (run) {
+                    promise.set_value(fn());
+                } else {
+                    promise.set_value(std::nullopt);
+                }
+            });
+        }
+    }
+    // Outside the lock: `fn` may post jobs of its own
+    if (direct) return fn();
+    return result.get();
+}
+
+} // namespace levin
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace levin {
+
+// How apply_budget_priorities() chooses which files get the download budget
+enum class FileSelection {
+    RANDOM,        // fixed per-torrent shuffle
+    RAREST_FIRST,  // least-replicated data first
+};
+
+// Availability of each file: the lowest piece availability over the pieces
+// it spans, i.e. how many connected peers could supply the whole file.
+// Files are laid out back to back (pad files included), as in a libtorrent
+// file_storage. Empty files and files past the end of piece_availability
+// get 0.
+std::vector<int> file_availability(const std::vector<int64_t>& file_sizes,
+                                   int piece_length,
+                                   const std::vector<int>& piece_availability);
+
+// File indices ordered rarest first. Files no connected peer can supply
+// (availability 0) go last, since budget spent on them can't be used yet.
+// Ties keep their relative order in base_order.
+std::vector<int> rank_rarest_first(const std::vector<int>& availability,
+                                   const std::vector<int>& base_order);
+
+// Sort key for a torrent's swarm: tracker-scraped seed count, or the number
+// of connected seeds when the tracker hasn't reported one (scrape < 0).
+int swarm_seed_count(int scrape_complete, int connected_seeds);
+
+} // namespace levin
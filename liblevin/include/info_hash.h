@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace levin {
+
+// Binary torrent info-hash: the SHA-1 of a v1 or hybrid torrent, or the
+// SHA-256 of a v2-only one. Kept binary inside the library; hex is only
+// produced for the C API and for file names.
+class InfoHash {
+public:
+    static constexpr size_t V1_SIZE = 20;
+    static constexpr size_t V2_SIZE = 32;
+    static constexpr size_t MAX_HEX = 2 * V2_SIZE;
+
+    InfoHash() = default;
+    // Bytes beyond V2_SIZE are ignored
+    InfoHash(const void* data, size_t size);
+
+    // nullopt unless hex is 40 or 64 hex digits
+    static std::optional<InfoHash> from_hex(std::string_view hex);
+    std::string to_hex() const;
+    // Writes the hex digits and a terminating NUL; out needs 2 * size() + 1 chars
+    void to_hex(char* out) const;
+
+    const uint8_t* data() const { return bytes_.data(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // The bytes are already uniformly distributed, so the first word is the hash
+    size_t hash_code() const {
+        uint64_t h;
+        std::memcpy(&h, bytes_.data(), sizeof(h));
+        return static_cast<size_t>(h);
+    }
+
+    friend bool operator==(const InfoHash& a, const InfoHash& b) {
+        return a.size_ == b.size_ && a.bytes_ == b.bytes_;
+    }
+    friend bool operator!=(const InfoHash& a, const InfoHash& b) { return !(a == b); }
+    friend bool operator<(const InfoHash& a, const InfoHash& b) {
+        return a.size_ != b.size_ ? a.size_ < b.size_ : a.bytes_ < b.bytes_;
+    }
+
+private:
+    std::array<uint8_t, V2_SIZE> bytes_{};  // zero past size_, so whole-array compares work
+    uint8_t size_ = 0;
+};
+
+} // namespace levin
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "info_hash.h"
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace levin {
+
+// Open-addressing hash map keyed by InfoHash. Entries live inline in one
+// slot array (linear probing, backward-shift deletion, no tombstones), so a
+// lookup touches one or two cache lines instead of chasing bucket nodes.
+// Inserts may move every entry and erase may move the entries after it:
+// references and iterators are only good until the next insert or erase.
+template <typename V>
+class InfoHashMap {
+public:
+    using value_type = std::pair<const InfoHash, V>;
+
+    template <bool Const>
+    class Iter {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename InfoHashMap::value_type;
+        using Slots = std::conditional_t<Const, const std::vector<std::optional<value_type>>,
+                                         std::vector<std::optional<value_type>>>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        Iter(Slots* slots, size_t pos) : slots_(slots), pos_(pos) { skip_empty(); }
+        // iterator -> const_iterator
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iter(const Iter<false>& other) : slots_(other.slots_), pos_(other.pos_) {}
+
+        reference operator*() const { return *(*slots_)[pos_]; }
+        pointer operator->() const { return &*(*slots_)[pos_]; }
+        Iter& operator++() {
+            pos_++;
+            skip_empty();
+            return *this;
+        }
+        bool operator==(const Iter& o) const { return pos_ == o.pos_; }
+        bool operator!=(const Iter& o) const { return pos_ != o.pos_; }
+
+    private:
+        friend class InfoHashMap;
+        friend class Iter<true>;
+        void skip_empty() {
+            while (pos_ < slots_->size() && !(*slots_)[pos_]) pos_++;
+        }
+        Slots* slots_;
+        size_t pos_;
+    };
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    iterator begin() { return iterator(&slots_, 0); }
+    iterator end() { return iterator(&slots_, slots_.size()); }
+    const_iterator begin() const { return const_iterator(&slots_, 0); }
+    const_iterator end() const { return const_iterator(&slots_, slots_.size()); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return slots_.size(); }
+
+    void clear() {
+        slots_.clear();
+        size_ = 0;
+    }
+
+    // Room for n entries without rehashing
+    void reserve(size_t n) {
+        size_t cap = MIN_CAPACITY;
+        while (cap * MAX_LOAD_NUM < n * MAX_LOAD_DEN) cap <<= 1;
+        if (cap > slots_.size()) rehash(cap);
+    }
+
+    iterator find(const InfoHash& key) { return iterator(&slots_, locate(key)); }
+    const_iterator find(const InfoHash& key) const { return const_iterator(&slots_, locate(key)); }
+    size_t count(const InfoHash& key) const { return locate(key) != slots_.size() ? 1 : 0; }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const InfoHash& key, Args&&... args) {
+        if ((size_ + 1) * MAX_LOAD_DEN > slots_.size() * MAX_LOAD_NUM) {
+            rehash(slots_.empty() ? MIN_CAPACITY : slots_.size() * 2);
+        }
+        size_t mask = slots_.size() - 1;
+        size_t i = key.hash_code() & mask;
+        for (; slots_[i]; i = (i + 1) & mask) {
+            if (slots_[i]->first == key) return {iterator(&slots_, i), false};
+        }
+        slots_[i].emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+        size_++;
+        return {iterator(&slots_, i), true};
+    }
+
+    V& operator[](const InfoHash& key) { return try_emplace(key).first->second; }
+
+    size_t erase(const InfoHash& key) {
+        size_t hole = locate(key);
+        if (hole == slots_.size()) return 0;
+        slots_[hole].reset();
+        size_--;
+
+        // Pull later entries of the probe run back into the hole, unless
+        // their home slot lies cyclically after it
+        size_t mask = slots_.size() - 1;
+        for (size_t j = (hole + 1) & mask; slots_[j]; j = (j + 1) & mask) {
+            size_t home = slots_[j]->first.hash_code() & mask;
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                slots_[hole].emplace(std::move(*slots_[j]));
+                slots_[j].reset();
+                hole = j;
+            }
+        }
+        return 1;
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 16;
+    // Linear probing stays short below 3/4 full
+    static constexpr size_t MAX_LOAD_NUM = 3;
+    static constexpr size_t MAX_LOAD_DEN = 4;
+
+    // Slot index of key, or slots_.size() if absent
+    size_t locate(const InfoHash& key) const {
+        if (size_ == 0) return slots_.size();
+        size_t mask = slots_.size() - 1;
+        for (size_t i = key.hash_code() & mask; slots_[i]; i = (i + 1) & mask) {
+            if (slots_[i]->first == key) return i;
+        }
+        return slots_.size();
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<std::optional<value_type>> old(capacity);
+        old.swap(slots_);
+        size_t mask = capacity - 1;
+        for (auto& slot : old) {
+            if (!slot) continue;
+            size_t i = slot->first.hash_code() & mask;
+            while (slots_[i]) i = (i + 1) & mask;
+            slots_[i].emplace(std::move(*slot));
+        }
+    }
+
+    std::vector<std::optional<value_type>> slots_;
+    size_t size_ = 0;
+};
+
+} // namespace levin
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+namespace levin {
+
+// Storage class the libtorrent disk subsystem is tuned for
+enum class IoProfile {
+    AUTO,   // detect from the device holding the data directory
+    SD,     // phone SD card / eMMC: slow, stall-prone writes
+    SSD,
+    HDD,    // rotational: seeks dominate
+    NVME,
+};
+
+enum class DiskWriteMode {
+    OS_CACHE,       // buffered writes
+    WRITE_THROUGH,  // flush as we go, so dirty pages can't pile up into a stall
+};
+
+struct DiskIoSettings {
+    int aio_threads;
+    int hashing_threads;
+    DiskWriteMode write_mode;
+    int max_queued_disk_bytes;
+    int send_buffer_low_watermark;
+    int send_buffer_watermark;
+    int send_buffer_watermark_factor;  // percent of upload rate kept buffered
+};
+
+// libtorrent disk settings for a profile. AUTO gives the SSD settings.
+DiskIoSettings io_settings_for(IoProfile profile);
+
+// Detect the profile of the block device holding `path` from sysfs:
+// mmcblk devices are SD, nvme devices NVME, rotational devices HDD and
+// anything else SSD. Returns SSD when the device can't be identified.
+// `sysfs_root` is overridable for tests.
+IoProfile detect_io_profile(const std::string& path, const std::string& sysfs_root = "/sys");
+
+// "sd", "ssd", "hdd", "nvme", "auto" (case-sensitive); AUTO for anything else
+IoProfile parse_io_profile(const std::string& name);
+const char* io_profile_name(IoProfile profile);
+
+} // namespace levin
@@ -17,6 +17,19 @@ typedef enum {
     LEVIN_STATE_DOWNLOADING = 4
 } levin_state_t;
 
+typedef enum {
+    LEVIN_FILE_SELECTION_RANDOM        = 0,  /* fixed random order per torrent */
+    LEVIN_FILE_SELECTION_RAREST_FIRST  = 1   /* least-replicated files first */
+} levin_file_selection_t;
+
+typedef enum {
+    LEVIN_IO_PROFILE_AUTO  = 0,  /* detect from the data directory's device */
+    LEVIN_IO_PROFILE_SD    = 1,  /* SD card / eMMC */
+    LEVIN_IO_PROFILE_SSD   = 2,
+    LEVIN_IO_PROFILE_HDD   = 3,
+    LEVIN_IO_PROFILE_NVME  = 4
+} levin_io_profile_t;
+
 typedef struct {
     const char* watch_directory;
     const char* data_directory;
@@ -30,6 +43,15 @@ typedef struct {
     int         max_download_kbps;     /* 0 = unlimited */
     int         max_upload_kbps;       /* 0 = unlimited */
     const char* stun_server;           /* default: "stun.l.google.com:19302" */
+    levin_file_selection_t file_selection; /* which files the disk budget goes to first */
+    levin_io_profile_t io_profile;     /* disk I/O tuning, default: auto */
+    uint64_t    memory_budget_bytes;   /* session memory ceiling, 0 = unlimited */
+    int         unload_inactive;       /* drop idle seeds from the session, default: 0 */
+    int         pause_grace_secs;      /* PAUSED keeps peers connected this long, 0 = pause at once */
+    int         state_debounce_secs;   /* battery/network changes must hold this long, 0 = at once */
+    int         state_min_dwell_secs;  /* after dropping to a less active state, stay this long */
+    int         track_data_directory;  /* follow data_directory changes via filesystem events, default: 0 */
+    int         eviction_cooldown_secs; /* after an eviction, keep its space free this long (longer on repeats), 0 = off */
 } levin_config_t;
 
 typedef struct {
@@ -44,10 +66,20 @@ typedef struct {
     uint64_t      disk_budget;
     int           over_budget;
     int           file_count;       /* non-empty files in data dir (books seeding) */
+    uint64_t      disk_queued_bytes; /* bytes waiting to be written to disk */
+    int           startup_pending;  /* .torrent files still queued by staged startup */
+    int           startup_total;    /* .torrent files found at levin_start() */
+    uint64_t      memory_budget;    /* configured memory_budget_bytes, 0 = unlimited */
+    uint64_t      memory_estimate;  /* estimated session memory use */
+    int           soft_paused;      /* PAUSED, peers still connected (pause_grace_secs) */
+    uint64_t      suppressed_transitions; /* condition flips that reverted before taking effect */
+    uint64_t      eviction_pending; /* bytes still being deleted in the background */
+    uint64_t      wasted_bytes;     /* downloaded, then evicted before any of it was uploaded */
+    int           eviction_cooldown_secs; /* budget held below the last eviction this much longer */
 } levin_status_t;
 
 typedef struct {
-    char          info_hash[41];    /* hex string, null-terminated */
+    char          info_hash[65];    /* hex, null-terminated: 40 chars, 64 for v2-only torrents */
     const char*   name;
     uint64_t      size;
     uint64_t      downloaded;
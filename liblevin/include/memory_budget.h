@@ -0,0 +1,40 @@
+#pragma once
+
+#include "io_profile.h"
+
+#include <cstdint>
+
+namespace levin {
+
+// libtorrent settings that bound the session's memory use
+struct MemorySettings {
+    int connections_limit;
+    int max_peerlist_size;         // per started torrent
+    int max_paused_peerlist_size;  // per paused/queued torrent
+    int alert_queue_size;
+    int max_queued_disk_bytes;
+    int send_buffer_low_watermark;
+    int send_buffer_watermark;
+};
+
+// Rough per-object costs behind the estimate. Deliberately on the high side.
+struct MemoryCosts {
+    static constexpr uint64_t BASE = 24ULL << 20;           // session, DHT, threads, our own state
+    static constexpr uint64_t PER_TORRENT = 96ULL << 10;    // torrent object, piece picker, metadata, caches
+    static constexpr uint64_t PER_CONNECTION = 48ULL << 10; // peer object and receive buffer; send buffer extra
+    static constexpr uint64_t PER_PEER_ENTRY = 64;          // one peer-list entry
+    static constexpr uint64_t PER_ALERT = 512;
+};
+
+// Settings that keep a session with `torrents` loaded (`active_torrents` of
+// them started) inside budget_bytes. Never exceeds the I/O profile's disk
+// queue and send buffers. budget_bytes == 0 means unlimited: libtorrent's
+// defaults, with the profile's I/O values.
+MemorySettings derive_memory_settings(uint64_t budget_bytes, int torrents, int active_torrents,
+                                      const DiskIoSettings& io);
+
+// Estimated resident memory for the given load
+uint64_t estimate_memory_usage(int torrents, int connections, uint64_t disk_queued_bytes,
+                               const MemorySettings& settings);
+
+} // namespace levin
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace levin {
+
+// What we know about a seeding torrent's demand
+struct SeedCandidate {
+    double upload_rate = 0;  // bytes/sec, smoothed over the periods it was active
+    int leechers = 0;        // peers in the swarm still downloading
+    int seeds = 0;           // seeds in the swarm
+    bool active = false;     // currently holds a seeding slot
+    int64_t idle_secs = 0;   // time since it last held a slot (large if never)
+};
+
+// Demand score: measured upload plus credit for leechers that have few
+// other seeds to download from.
+double seed_demand_score(const SeedCandidate& c);
+
+// Choose which seeds hold the `slots` seeding slots. Most slots go to the
+// highest demand; `probe_slots` of them rotate to the torrents idle the
+// longest, so demand gets measured for every torrent over time. Returns a
+// flag per candidate.
+std::vector<bool> choose_active_seeds(const std::vector<SeedCandidate>& candidates,
+                                      int slots, int probe_slots);
+
+} // namespace levin
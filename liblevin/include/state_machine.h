@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 
 namespace levin {
 
+// Ordered from least to most active
 enum class State {
     OFF,
     PAUSED,
@@ -12,12 +16,25 @@ enum class State {
     DOWNLOADING
 };
 
+// Inputs the state is derived from
+enum class Condition {
+    ENABLED,
+    BATTERY,
+    NETWORK,
+    HAS_TORRENTS,
+    STORAGE
+};
+
 // Callback: (old_state, new_state)
 using StateCallback = std::function<void(State, State)>;
 
+// Time source for debouncing; steady_clock::now by default
+using StateClock = std::function<std::chrono::steady_clock::time_point()>;
+
 class StateMachine {
 public:
     StateMachine();
+    explicit StateMachine(StateClock clock);
 
     State state() const;
 
@@ -29,15 +46,47 @@ public:
 
     void set_callback(StateCallback cb);
 
+    // A change of `c` only counts once it has held for `window`; one that
+    // reverts sooner is dropped. Zero (the default) applies changes at once.
+    void set_debounce(Condition c, std::chrono::milliseconds window);
+
+    // After dropping to a less active state, stay there at least `dwell`
+    // before moving back up. Moving down is never delayed.
+    void set_min_dwell(State s, std::chrono::milliseconds dwell);
+
+    // Apply debounced changes and dwell times that have run out. Call
+    // periodically; updates alone only move time forward when they arrive.
+    void tick();
+
+    // Condition flips and deferred transitions that were dropped because
+    // they reverted before taking effect
+    uint64_t suppressed_transitions() const;
+
 private:
-    void evaluate();
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    struct Input {
+        bool known = false;      // first report is taken as is, without debouncing
+        bool value = false;      // value the state is derived from
+        bool pending = false;    // a flip of `value` is waiting out the debounce window
+        TimePoint pending_since;
+        std::chrono::milliseconds debounce{0};
+    };
+
+    void update(Condition c, bool value);
+    void settle(TimePoint now);
+    void evaluate(TimePoint now);
+    State target_state() const;
+    Input& input(Condition c) { return inputs_[static_cast<size_t>(c)]; }
+    bool value(Condition c) const { return inputs_[static_cast<size_t>(c)].value; }
 
     State current_state_;
-    bool enabled_;
-    bool battery_ok_;
-    bool network_ok_;
-    bool has_torrents_;
-    bool storage_ok_;
+    std::array<Input, 5> inputs_{};
+    std::array<std::chrono::milliseconds, 5> min_dwell_{};
+    TimePoint hold_until_{};   // no moving up before this
+    bool deferred_ = false;    // a move up is waiting for hold_until_
+    uint64_t suppressed_ = 0;
+    StateClock clock_;
     StateCallback callback_;
 };
 
@@ -13,6 +13,7 @@ struct Statistics {
     uint64_t total_uploaded = 0;
     uint64_t session_downloaded = 0;  // Current session only
     uint64_t session_uploaded = 0;    // Current session only
+    uint64_t total_wasted = 0;        // Downloaded, then evicted before any upload
 
     // Load stats from file. Returns false if file doesn't exist or is corrupt.
     bool load(const std::string& path);
@@ -22,8 +23,12 @@ struct Statistics {
 
     // Update session counters and recompute totals.
     // base_downloaded/uploaded are the cumulative values from before this session.
+    // Totals never decrease, even if the session counters go backwards.
     void update(uint64_t base_downloaded, uint64_t base_uploaded,
                 uint64_t current_session_downloaded, uint64_t current_session_uploaded);
+
+    // Same for wasted bytes
+    void update_wasted(uint64_t base_wasted, uint64_t current_session_wasted);
 };
 
 } // namespace levin
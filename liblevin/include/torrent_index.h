@@ -0,0 +1,85 @@
+#pragma once
+
+#include "info_hash.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace levin {
+
+struct TorrentMetadata {
+    InfoHash info_hash;
+    std::string name;
+    uint64_t total_size = 0;
+    uint32_t file_count = 0;
+    uint32_t piece_length = 0;
+    std::vector<uint64_t> file_sizes;   // only filled when requested
+};
+
+/**
+ * Persistent index of parsed .torrent metadata, keyed by the .torrent path
+ * and validated against its mtime and size. The index file is memory-mapped
+ * on open, so looking up an entry (including its per-file size table) never
+ * bdecodes the torrent and costs no heap until a value is copied out.
+ */
+class TorrentIndex {
+public:
+    TorrentIndex() = default;
+    ~TorrentIndex();
+
+    TorrentIndex(const TorrentIndex&) = delete;
+    TorrentIndex& operator=(const TorrentIndex&) = delete;
+
+    // Map the index file at path. A missing or corrupt file gives an empty
+    // index that will be written to path on save(). Returns false only if
+    // an existing file could not be read.
+    bool open(const std::string& path);
+    void close();
+
+    // Metadata for the .torrent at torrent_path, if indexed and the file's
+    // mtime and size still match.
+    std::optional<TorrentMetadata> find(const std::string& torrent_path,
+                                        bool with_file_sizes = false) const;
+
+    // Record metadata for the .torrent at torrent_path (stats the file).
+    // Paths longer than 65535 bytes are not indexed.
+    void put(const std::string& torrent_path, TorrentMetadata meta);
+    void remove(const std::string& torrent_path);
+
+    // Drop entries for every path not in keep (e.g. deleted .torrent files).
+    void retain_only(const std::vector<std::string>& keep);
+
+    // Rewrite the index file if anything changed, then re-map it.
+    bool save();
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Stamp {
+        int64_t mtime = 0;
+        uint64_t size = 0;
+    };
+
+    // An entry lives either in the mapped file (offset) or in memory (owned)
+    struct Slot {
+        Stamp stamp;
+        size_t offset = 0;
+        std::optional<TorrentMetadata> owned;
+    };
+
+    static std::optional<Stamp> stat_file(const std::string& path);
+    TorrentMetadata read_mapped(size_t offset, bool with_file_sizes) const;
+    bool parse_mapped();
+
+    std::string path_;
+    const uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    std::vector<uint8_t> fallback_;     // file contents where mmap is unavailable
+    std::unordered_map<std::string, Slot> entries_;
+    bool dirty_ = false;
+};
+
+} // namespace levin
@@ -1,6 +1,11 @@
 #pragma once
 
+#include "file_selection.h"
+#include "info_hash.h"
+#include "io_profile.h"
+
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -8,8 +13,11 @@
 
 namespace levin {
 
+class EvictionIndex;
+class TorrentIndex;
+
 struct TorrentInfo {
-    std::string info_hash;
+    InfoHash info_hash;
     std::string name;
     uint64_t size;
     uint64_t downloaded;
@@ -21,19 +29,73 @@ struct TorrentInfo {
     bool is_seed;
 };
 
+// Session-wide counters sampled from libtorrent's session_stats_alert.
+// Byte counters are cumulative for the lifetime of the session, so unlike
+// per-torrent sums they do not drop when a torrent is removed.
+struct SessionMetrics {
+    uint64_t net_recv_bytes = 0;       // all bytes received, including protocol overhead
+    uint64_t net_sent_bytes = 0;
+    uint64_t payload_recv_bytes = 0;   // piece data only
+    uint64_t payload_sent_bytes = 0;
+    uint64_t disk_queued_bytes = 0;    // bytes waiting to be written to disk
+    int disk_queued_jobs = 0;
+    int peers_connected = 0;
+    int peers_half_open = 0;
+    int peers_tcp = 0;
+    int peers_utp = 0;
+    int peers_ssl = 0;
+    int peers_webrtc = 0;
+};
+
+// Changes to the data directory seen in session alerts since the last
+// take_disk_usage_delta(), so disk usage can be kept current without
+// walking the directory
+struct DiskUsageDelta {
+    int64_t bytes = 0;    // piece data written
+    int files = 0;        // files completed
+    bool rescan = false;  // a storage event the delta can't account for
+};
+
+// Runs a job that unlinks files or punches holes, possibly on another thread
+using DiskJobRunner = std::function<void(std::function<void()> job)>;
+
 // Abstract interface for torrent session -- allows stub and real implementations
 class ITorrentSession {
 public:
     virtual ~ITorrentSession() = default;
 
     virtual void configure(int port, const std::string& stun_server) = 0;
+    // Disk subsystem tuning, applied by the next start()
+    virtual void set_io_profile(IoProfile profile) = 0;
+    // Memory ceiling libtorrent's buffers and limits are sized for, applied
+    // by the next start(); 0 = unlimited
+    virtual void set_memory_budget(uint64_t bytes) = 0;
     virtual void start(const std::string& data_directory) = 0;
     virtual void stop() = 0;
     virtual bool is_running() const = 0;
 
+    // Drain pending session alerts and refresh cached torrent status.
+    // Call periodically from the tick thread; the stats getters and
+    // get_torrent_list() only read what this last cached.
+    virtual void process_alerts() = 0;
+
     // Torrent management
-    virtual std::optional<std::string> add_torrent(const std::string& torrent_path) = 0;
-    virtual void remove_torrent(const std::string& info_hash) = 0;
+    virtual std::optional<InfoHash> add_torrent(const std::string& torrent_path) = 0;
+    // Like add_torrent(), but returns right away: the file is parsed on a
+    // worker thread and added by a later process_alerts(). Returns false if
+    // the session isn't running.
+    virtual bool async_add_torrent(const std::string& torrent_path) = 0;
+    // Torrents passed to async_add_torrent() that aren't registered yet
+    virtual int pending_adds() const = 0;
+    // True if resume data from a previous run shows the torrent at this path
+    // had downloaded everything it wanted, so it can seed straight away.
+    virtual bool is_known_seed(const std::string& torrent_path) const = 0;
+    // Register a known seed without loading it into libtorrent: only its
+    // hash, indexed metadata and resume data are kept until the seeding
+    // scheduler gives it a slot. Returns false (add it normally instead)
+    // unless unload mode is on and both index entry and resume data exist.
+    virtual bool add_unloaded_torrent(const std::string& torrent_path) = 0;
+    virtual void remove_torrent(const InfoHash& info_hash) = 0;
     virtual int torrent_count() const = 0;
 
     // Torrent listing
@@ -41,12 +103,19 @@ public:
 
     // Session control
     virtual void pause_session() = 0;
-    virtual void resume_session() = 0;
+    virtual void resume_session() = 0;   // also ends a soft pause
     virtual bool is_paused() const = 0;
+    // Stop transfers but keep peer connections and the DHT, for short
+    // interruptions. pause_session() escalates it to a full pause.
+    virtual void soft_pause_session() = 0;
+    virtual bool is_soft_paused() const = 0;
 
     // Download rate control
-    virtual void pause_downloads() = 0;   // set download rate to 1 byte/sec
-    virtual void resume_downloads() = 0;  // restore configured rate
+    // Seed-only mode: torrents keep uploading but request no pieces.
+    // resume_downloads() restores them as they were; rate limits are separate.
+    virtual void pause_downloads() = 0;
+    virtual void resume_downloads() = 0;
+    virtual bool downloads_paused() const = 0;
     virtual void set_download_rate_limit(int bytes_per_sec) = 0;
     virtual void set_upload_rate_limit(int bytes_per_sec) = 0;
     virtual int get_download_rate_limit() const = 0;
@@ -55,31 +124,87 @@ public:
     virtual int peer_count() const = 0;
     virtual int download_rate() const = 0;
     virtual int upload_rate() const = 0;
+    // Payload bytes transferred by this session; monotonic until stop()
     virtual uint64_t total_downloaded() const = 0;
     virtual uint64_t total_uploaded() const = 0;
+    // Bytes evicted from torrents that had never uploaded anything, so
+    // downloaded for nothing; monotonic until stop()
+    virtual uint64_t wasted_bytes() const = 0;
+    virtual SessionMetrics session_metrics() const = 0;
+    // Estimated resident memory of the session (see memory_budget.h)
+    virtual uint64_t memory_estimate() const = 0;
+    // Returns and resets the disk usage change collected by process_alerts()
+    virtual DiskUsageDelta take_disk_usage_delta() = 0;
 
     // WebTorrent
     virtual bool is_webtorrent_enabled() const = 0;
-    virtual std::vector<std::string> get_trackers(const std::string& info_hash) const = 0;
+    virtual std::vector<std::string> get_trackers(const InfoHash& info_hash) const = 0;
 
     // Budget-aware file priorities: disable downloading files that don't fit in budget
     virtual void apply_budget_priorities(uint64_t budget_bytes) = 0;
+    // Which files apply_budget_priorities() funds first
+    virtual void set_file_selection(FileSelection mode) = 0;
+    // Delete files under the data directory through the torrents that own
+    // them. Each owner stops wanting the files and forgets their pieces
+    // before anything is unlinked, so it neither serves read errors for them
+    // nor downloads them again. The unlink follows a few ticks later, once
+    // the torrent is out of the session; it is then added back from the
+    // edited resume data. Returns the paths no torrent in the session owns,
+    // for the caller to delete itself.
+    virtual std::vector<std::string> evict_files(const std::vector<std::string>& paths) = 0;
+    // Free about `bytes` of one large file by punching holes over whole
+    // pieces it has, from the end of the file back, rather than deleting it.
+    // Like evict_files(), the pieces are dropped from the torrent first and
+    // the file stops being downloaded; the rest keeps seeding. Returns the
+    // bytes that will be freed, or 0 if no torrent in the session owns the
+    // file or holes can't be punched here.
+    virtual uint64_t shrink_file(const std::string& path, uint64_t bytes) = 0;
+    // Where the file work of evict_files() and shrink_file() runs; unset, it
+    // runs inline on the tick. The torrent is only added back, or rechecked,
+    // by a process_alerts() after its job has finished.
+    virtual void set_disk_job_runner(DiskJobRunner runner) = 0;
+    // Files evict_files() or shrink_file() take are not funded by the budget
+    // again for this long; 0 lets them back as soon as their torrent is
+    virtual void set_eviction_cooldown(int secs) = 0;
+    // Drop complete seeds that lose their seeding slot from the session,
+    // re-adding them when they win one back
+    virtual void set_unload_inactive(bool enabled) = 0;
 
     // Session state persistence
     virtual void save_state(const std::string& path) = 0;
     virtual void load_state(const std::string& path) = 0;
+
+    // Per-torrent fast-resume data is kept in this directory. Set before
+    // start(); an empty path disables resume data.
+    virtual void set_resume_directory(const std::string& dir) = 0;
+
+    // Index that parsed torrents are recorded in and that budget planning
+    // reads per-file sizes from. Not owned; null disables it.
+    virtual void set_metadata_index(TorrentIndex* index) = 0;
+
+    // Ranking that upload demand, completions and swarm seed counts are fed
+    // into, keyed by torrent name. Not owned; null disables it.
+    virtual void set_eviction_index(EvictionIndex* index) = 0;
 };
 
 // Stub implementation for testing without libtorrent
 class StubTorrentSession : public ITorrentSession {
 public:
     void configure(int port, const std::string& stun_server) override;
+    void set_io_profile(IoProfile profile) override;
+    void set_memory_budget(uint64_t bytes) override;
     void start(const std::string& data_directory) override;
     void stop() override;
     bool is_running() const override;
 
-    std::optional<std::string> add_torrent(const std::string& torrent_path) override;
-    void remove_torrent(const std::string& info_hash) override;
+    void process_alerts() override;
+
+    std::optional<InfoHash> add_torrent(const std::string& torrent_path) override;
+    bool async_add_torrent(const std::string& torrent_path) override;
+    int pending_adds() const override;
+    bool is_known_seed(const std::string& torrent_path) const override;
+    bool add_unloaded_torrent(const std::string& torrent_path) override;
+    void remove_torrent(const InfoHash& info_hash) override;
     int torrent_count() const override;
 
     std::vector<TorrentInfo> get_torrent_list() const override;
@@ -87,9 +212,12 @@ public:
     void pause_session() override;
     void resume_session() override;
     bool is_paused() const override;
+    void soft_pause_session() override;
+    bool is_soft_paused() const override;
 
     void pause_downloads() override;
     void resume_downloads() override;
+    bool downloads_paused() const override;
     void set_download_rate_limit(int bytes_per_sec) override;
     void set_upload_rate_limit(int bytes_per_sec) override;
     int get_download_rate_limit() const override;
@@ -99,20 +227,35 @@ public:
     int upload_rate() const override;
     uint64_t total_downloaded() const override;
     uint64_t total_uploaded() const override;
+    uint64_t wasted_bytes() const override;
+    SessionMetrics session_metrics() const override;
+    uint64_t memory_estimate() const override;
+    DiskUsageDelta take_disk_usage_delta() override;
 
     bool is_webtorrent_enabled() const override;
-    std::vector<std::string> get_trackers(const std::string& info_hash) const override;
+    std::vector<std::string> get_trackers(const InfoHash& info_hash) const override;
 
     void apply_budget_priorities(uint64_t budget_bytes) override;
+    void set_file_selection(FileSelection mode) override;
+    std::vector<std::string> evict_files(const std::vector<std::string>& paths) override;
+    uint64_t shrink_file(const std::string& path, uint64_t bytes) override;
+    void set_disk_job_runner(DiskJobRunner runner) override;
+    void set_eviction_cooldown(int secs) override;
+    void set_unload_inactive(bool enabled) override;
 
     void save_state(const std::string& path) override;
     void load_state(const std::string& path) override;
+    void set_resume_directory(const std::string& dir) override;
+    void set_metadata_index(TorrentIndex* index) override;
+    void set_eviction_index(EvictionIndex* index) override;
 
 private:
     bool running_ = false;
     bool paused_ = false;
+    bool soft_paused_ = false;
     int download_rate_limit_ = 0;
     int upload_rate_limit_ = 0;
+    bool downloads_paused_ = false;
     int torrent_count_ = 0;
 };
 
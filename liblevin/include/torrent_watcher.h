@@ -3,6 +3,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace levin {
 
@@ -32,6 +33,9 @@ public:
     // Scan the directory for existing .torrent files and call on_add for each.
     void scan_existing();
 
+    // Existing .torrent files in the directory, sorted, without calling on_add.
+    std::vector<std::string> list_existing() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "dir_scanner.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace levin {
+
+/**
+ * Data directory usage as last known, kept in the state directory so a
+ * restart has usage, file count and budget right from the first tick
+ * instead of after a full walk. Binary file, replaced atomically.
+ */
+struct UsageSnapshot {
+    std::string data_directory;          // the snapshot only applies to this directory
+    uint64_t usage = 0;
+    int file_count = 0;
+    std::vector<TopLevelUsage> entries;  // per top-level entry, from the last full walk
+
+    // Load from file. Returns false if it doesn't exist or is corrupt.
+    bool load(const std::string& path);
+
+    // Save to file (via a temporary and rename). Returns false on write error.
+    bool save(const std::string& path) const;
+};
+
+} // namespace levin
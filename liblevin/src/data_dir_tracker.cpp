@@ -0,0 +1,284 @@
+#include "data_dir_tracker.h"
+
+#include <string>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <cerrno>
+#include <chrono>
+#include <future>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace levin {
+
+#ifdef __linux__
+
+namespace {
+
+const uint32_t WATCH_MASK = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE |
+                            IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+// FNV-1a over the watch descriptor and name. Files are keyed by this hash
+// rather than by name so a large library costs a few words per file; a
+// collision only skews the totals until the next full measurement.
+uint64_t file_key(int wd, const char* name) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&h](unsigned char c) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    };
+    for (size_t i = 0; i < sizeof(wd); i++) mix(static_cast<unsigned char>(wd >> (8 * i)));
+    for (const char* p = name; *p; p++) mix(static_cast<unsigned char>(*p));
+    return h;
+}
+
+bool is_dot_entry(const char* name) {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+// One measurement of the tree: its watches, on an inotify instance of its
+// own, and the files found under them
+struct WatchedTree {
+    struct FileState {
+        uint64_t allocated;
+        bool non_empty;
+    };
+
+    int inotify_fd = -1;
+    std::unordered_map<int, std::string> dirs;      // watch descriptor -> path
+    std::unordered_map<uint64_t, FileState> files;  // file_key(wd, name) -> state
+    uint64_t usage = 0;
+    int file_count = 0;
+
+    WatchedTree() = default;
+    WatchedTree(const WatchedTree&) = delete;
+    WatchedTree& operator=(const WatchedTree&) = delete;
+    ~WatchedTree() {
+        if (inotify_fd >= 0) close(inotify_fd);
+    }
+
+    // Replace what is known about one file; st == nullptr means it is gone
+    void set_file(uint64_t key, const struct stat* st) {
+        auto it = files.find(key);
+        if (it != files.end()) {
+            usage -= it->second.allocated;
+            if (it->second.non_empty) file_count--;
+        }
+        if (!st) {
+            if (it != files.end()) files.erase(it);
+            return;
+        }
+        // st_blocks is in 512-byte units
+        FileState state{static_cast<uint64_t>(st->st_blocks) * 512, st->st_size > 0};
+        usage += state.allocated;
+        if (state.non_empty) file_count++;
+        if (it != files.end()) {
+            it->second = state;
+        } else {
+            files.emplace(key, state);
+        }
+    }
+
+    // Watch `path` and everything below it, counting the files found.
+    // The watch goes in before the directory is read, so files created in
+    // between also show up as events. Returns false when out of watches.
+    bool add_tree(const std::string& path) {
+        int wd = inotify_add_watch(inotify_fd, path.c_str(), WATCH_MASK);
+        if (wd < 0) return errno != ENOSPC && errno != ENOMEM;
+        dirs[wd] = path;
+
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return true;
+        int dfd = dirfd(dir);
+        bool ok = true;
+        while (struct dirent* e = readdir(dir)) {
+            if (is_dot_entry(e->d_name)) continue;
+            struct stat st;
+            if (fstatat(dfd, e->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+            if (S_ISDIR(st.st_mode)) {
+                if (!add_tree(path + "/" + e->d_name)) {
+                    ok = false;
+                    break;
+                }
+            } else if (S_ISREG(st.st_mode)) {
+                set_file(file_key(wd, e->d_name), &st);
+            }
+        }
+        closedir(dir);
+        return ok;
+    }
+};
+
+// Watch and measure the tree from scratch. Runs on a background thread;
+// null if inotify or its watches aren't available.
+std::unique_ptr<WatchedTree> measure_tree(std::string root) {
+    auto tree = std::make_unique<WatchedTree>();
+    tree->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (tree->inotify_fd < 0) return nullptr;
+    if (!tree->add_tree(root) || tree->dirs.empty()) return nullptr;
+    return tree;
+}
+
+} // anonymous namespace
+
+struct DataDirTracker::Impl {
+    // A file whose size must be looked up again once the queue is drained
+    struct Changed {
+        int wd;
+        std::string name;
+    };
+
+    std::string root;
+    std::unique_ptr<WatchedTree> tree;                   // null until first measured
+    std::future<std::unique_ptr<WatchedTree>> measuring;  // in the background
+    uint64_t rescans = 0;
+
+    // The current tree, if any, keeps following events and reporting its
+    // totals until the new one is adopted by poll()
+    void measure() {
+        if (measuring.valid()) return;
+        measuring = std::async(std::launch::async, measure_tree, root);
+    }
+};
+
+DataDirTracker::DataDirTracker() : impl_(std::make_unique<Impl>()) {}
+
+DataDirTracker::~DataDirTracker() {
+    stop();
+}
+
+int DataDirTracker::start(const std::string& root) {
+    stop();
+    struct stat st;
+    if (stat(root.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return -1;
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return -1;
+    close(fd);
+
+    impl_->root = root;
+    impl_->rescans = 0;
+    impl_->measure();
+    return 0;
+}
+
+void DataDirTracker::stop() {
+    if (impl_->measuring.valid()) impl_->measuring.wait();
+    impl_->measuring = {};
+    impl_->tree.reset();
+}
+
+bool DataDirTracker::active() const {
+    return impl_->tree != nullptr;
+}
+
+bool DataDirTracker::measuring() const {
+    return impl_->measuring.valid();
+}
+
+void DataDirTracker::poll() {
+    // Adopt a finished measurement; events since it set its watches are
+    // queued on its own descriptor and read below
+    if (impl_->measuring.valid() &&
+        impl_->measuring.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        bool first = !impl_->tree;
+        impl_->tree = impl_->measuring.get();
+        if (!impl_->tree) return;  // no watches: the caller walks instead
+        if (!first) impl_->rescans++;
+    }
+    WatchedTree* tree = impl_->tree.get();
+    if (!tree) return;
+
+    // Several events per file are common (create, modify..., close), so
+    // files are only looked at once, after the queue is drained
+    std::unordered_map<uint64_t, Impl::Changed> changed;
+    bool rescan = false;
+    bool out_of_watches = false;
+
+    alignas(struct inotify_event) char buf[64 * 1024];
+    for (;;) {
+        ssize_t len = read(tree->inotify_fd, buf, sizeof(buf));
+        if (len <= 0) break;  // EAGAIN: drained
+
+        for (const char* ptr = buf; ptr < buf + len;) {
+            const auto* ev = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                rescan = true;
+            } else if (ev->mask & IN_IGNORED) {
+                tree->dirs.erase(ev->wd);  // directory deleted (its files went first)
+            } else if (ev->len > 0 && (ev->mask & IN_ISDIR)) {
+                auto dir = tree->dirs.find(ev->wd);
+                if (dir == tree->dirs.end()) continue;
+                if (ev->mask & IN_MOVED_FROM) {
+                    // The subtree's files are keyed under watches we can't
+                    // enumerate cheaply; measure again instead
+                    rescan = true;
+                } else if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    if (!tree->add_tree(dir->second + "/" + ev->name)) out_of_watches = true;
+                }
+            } else if (ev->len > 0) {
+                uint64_t key = file_key(ev->wd, ev->name);
+                changed.try_emplace(key, Impl::Changed{ev->wd, ev->name});
+            }
+        }
+    }
+
+    if (out_of_watches) {
+        // Partial coverage would under-count; let the caller walk instead
+        stop();
+        return;
+    }
+
+    for (const auto& [key, c] : changed) {
+        auto dir = tree->dirs.find(c.wd);
+        struct stat st;
+        bool present = dir != tree->dirs.end() &&
+                       fstatat(AT_FDCWD, (dir->second + "/" + c.name).c_str(), &st, AT_SYMLINK_NOFOLLOW) == 0 &&
+                       S_ISREG(st.st_mode);
+        tree->set_file(key, present ? &st : nullptr);
+    }
+
+    // Until then the totals are the last known ones, plus what events
+    // still say
+    if (rescan) impl_->measure();
+}
+
+uint64_t DataDirTracker::usage() const {
+    return impl_->tree ? impl_->tree->usage : 0;
+}
+
+int DataDirTracker::file_count() const {
+    return impl_->tree ? impl_->tree->file_count : 0;
+}
+
+#else // no recursive change notification: callers keep walking the tree
+
+struct DataDirTracker::Impl {
+    uint64_t usage = 0;
+    int file_count = 0;
+    uint64_t rescans = 0;
+};
+
+DataDirTracker::DataDirTracker() : impl_(std::make_unique<Impl>()) {}
+DataDirTracker::~DataDirTracker() = default;
+int DataDirTracker::start(const std::string&) { return -1; }
+void DataDirTracker::stop() {}
+bool DataDirTracker::active() const { return false; }
+bool DataDirTracker::measuring() const { return false; }
+void DataDirTracker::poll() {}
+uint64_t DataDirTracker::usage() const { return impl_->usage; }
+int DataDirTracker::file_count() const { return impl_->file_count; }
+
+#endif
+
+uint64_t DataDirTracker::rescans() const {
+    return impl_->rescans;
+}
+
+} // namespace levin
@@ -0,0 +1,275 @@
+#include "dir_scanner.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#include <filesystem>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace levin {
+
+static void collect_top_level(std::unordered_map<std::string, TopLevelUsage>& by_name, DirScan& out) {
+    out.top_level.reserve(by_name.size());
+    for (auto& [name, top] : by_name) {
+        top.name = name;
+        out.top_level.push_back(std::move(top));
+    }
+    std::sort(out.top_level.begin(), out.top_level.end(),
+              [](const TopLevelUsage& a, const TopLevelUsage& b) { return a.name < b.name; });
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+
+namespace {
+
+static const int MAX_SCAN_THREADS = 8;
+
+// Directories still to be read, as paths relative to the root. A worker
+// only gives up once the queue is empty and no other worker is reading a
+// directory that could add to it.
+class ScanQueue {
+public:
+    void push(std::string rel) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirs_.push_back(std::move(rel));
+        cv_.notify_one();
+    }
+
+    bool pop(std::string& rel) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !dirs_.empty() || busy_ == 0; });
+        if (dirs_.empty()) return false;
+        rel = std::move(dirs_.front());
+        dirs_.pop_front();
+        busy_++;
+        return true;
+    }
+
+    void done() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_ == 0 && dirs_.empty()) cv_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::string> dirs_;
+    int busy_ = 0;
+};
+
+class ScanWorker {
+public:
+    ScanWorker(int root_fd, const std::string& root, const ScanOptions& options, ScanQueue& queue)
+        : root_fd_(root_fd), root_(root), collect_(options.collect_files)
+        , by_top_level_(options.by_top_level), queue_(queue) {}
+
+    void run() {
+        std::string rel;
+        while (queue_.pop(rel)) {
+            read_dir(rel);
+            queue_.done();
+        }
+    }
+
+    DirScan result;
+    std::unordered_map<std::string, TopLevelUsage> top_level;
+
+private:
+    void read_dir(const std::string& rel) {
+        int fd = ::openat(root_fd_, rel.empty() ? "." : rel.c_str(),
+                          O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) return;
+        // Top-level entry everything in this directory counts towards
+        // (empty for the root, where each file is its own entry)
+        current_top_ = by_top_level_ ? rel.substr(0, rel.find('/')) : std::string();
+
+#ifdef __linux__
+        // Raw getdents64 reads many entries per syscall. Record layout:
+        // u64 d_ino, s64 d_off, u16 d_reclen, u8 d_type, char d_name[]
+        if (buf_.empty()) buf_.resize(GETDENTS_BUF_SIZE);
+        for (;;) {
+            long n = ::syscall(SYS_getdents64, fd, buf_.data(), buf_.size());
+            if (n <= 0) break;
+            for (long off = 0; off < n;) {
+                const char* rec = buf_.data() + off;
+                uint16_t reclen;
+                std::memcpy(&reclen, rec + 16, sizeof(reclen));
+                visit(fd, rel, rec + 19, static_cast<unsigned char>(rec[18]));
+                off += reclen;
+            }
+        }
+        ::close(fd);
+#else
+        DIR* dir = ::fdopendir(fd);
+        if (!dir) {
+            ::close(fd);
+            return;
+        }
+        while (struct dirent* d = ::readdir(dir)) {
+            visit(fd, rel, d->d_name, d->d_type);
+        }
+        ::closedir(dir);
+#endif
+    }
+
+    void visit(int dir_fd, const std::string& rel, const char* name, unsigned char type) {
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) return;
+
+        if (type == DT_DIR) {
+            queue_.push(join(rel, name));
+            return;
+        }
+        // Symlinks, devices, etc. are intentionally skipped
+        if (type != DT_REG && type != DT_UNKNOWN) return;
+
+        struct stat st;
+        if (::fstatat(dir_fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) return;
+        if (S_ISDIR(st.st_mode)) {
+            queue_.push(join(rel, name));
+            return;
+        }
+        if (!S_ISREG(st.st_mode)) return;
+
+        // st_blocks is in 512-byte units
+        uint64_t allocated = static_cast<uint64_t>(st.st_blocks) * 512;
+        result.usage += allocated;
+        if (st.st_size > 0) result.file_count++;
+        if (by_top_level_) {
+            TopLevelUsage& top = top_level[rel.empty() ? std::string(name) : current_top_];
+            top.usage += allocated;
+            if (st.st_size > 0) top.file_count++;
+            top.newest_mtime = std::max<int64_t>(top.newest_mtime, st.st_mtime);
+        }
+        if (collect_) {
+            result.files.push_back({root_ + "/" + join(rel, name),
+                                    static_cast<uint64_t>(st.st_size), allocated});
+        }
+    }
+
+    static std::string join(const std::string& rel, const char* name) {
+        return rel.empty() ? std::string(name) : rel + "/" + name;
+    }
+
+    static constexpr size_t GETDENTS_BUF_SIZE = 64 * 1024;
+
+    int root_fd_;
+    const std::string& root_;
+    bool collect_;
+    bool by_top_level_;
+    ScanQueue& queue_;
+    std::vector<char> buf_;
+    std::string current_top_;
+};
+
+} // anonymous namespace
+
+DirScan scan_directory(const std::string& root, const ScanOptions& options) {
+    DirScan total;
+    int root_fd = ::open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root_fd < 0) return total;
+
+    int threads = options.threads;
+    if (threads <= 0) {
+        threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, MAX_SCAN_THREADS);
+    }
+
+    ScanQueue queue;
+    queue.push("");
+    std::deque<ScanWorker> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(root_fd, root, options, queue);
+    }
+    if (threads == 1) {
+        workers.front().run();
+    } else {
+        std::vector<std::thread> pool;
+        for (auto& w : workers) pool.emplace_back([&w] { w.run(); });
+        for (auto& t : pool) t.join();
+    }
+    ::close(root_fd);
+
+    std::unordered_map<std::string, TopLevelUsage> top_level;
+    for (auto& w : workers) {
+        for (auto& [name, part] : w.top_level) {
+            TopLevelUsage& top = top_level[name];
+            top.usage += part.usage;
+            top.file_count += part.file_count;
+            top.newest_mtime = std::max(top.newest_mtime, part.newest_mtime);
+        }
+        total.usage += w.result.usage;
+        total.file_count += w.result.file_count;
+        if (total.files.empty()) {
+            total.files = std::move(w.result.files);
+        } else {
+            total.files.insert(total.files.end(),
+                               std::make_move_iterator(w.result.files.begin()),
+                               std::make_move_iterator(w.result.files.end()));
+        }
+    }
+    collect_top_level(top_level, total);
+    return total;
+}
+
+bool scan_file(const std::string& path, ScannedFile& out) {
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+    out = {path, static_cast<uint64_t>(st.st_size), static_cast<uint64_t>(st.st_blocks) * 512};
+    return true;
+}
+
+#else
+
+DirScan scan_directory(const std::string& root, const ScanOptions& options) {
+    namespace fs = std::filesystem;
+    DirScan total;
+    std::unordered_map<std::string, TopLevelUsage> top_level;
+    std::error_code ec;
+    for (auto& entry : fs::recursive_directory_iterator(root, ec)) {
+        if (!entry.is_regular_file(ec) || entry.is_symlink(ec)) continue;
+        uint64_t sz = entry.file_size(ec);
+        if (ec) continue;
+        total.usage += sz;
+        if (sz > 0) total.file_count++;
+        if (options.collect_files) total.files.push_back({entry.path().string(), sz, sz});
+        if (options.by_top_level) {
+            TopLevelUsage& top = top_level[entry.path().lexically_relative(root).begin()->string()];
+            top.usage += sz;
+            if (sz > 0) top.file_count++;
+            auto mtime = entry.last_write_time(ec).time_since_epoch();
+            top.newest_mtime = std::max<int64_t>(
+                top.newest_mtime, std::chrono::duration_cast<std::chrono::seconds>(mtime).count());
+        }
+    }
+    collect_top_level(top_level, total);
+    return total;
+}
+
+bool scan_file(const std::string& path, ScannedFile& out) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_regular_file(fs::symlink_status(path, ec))) return false;
+    uint64_t sz = fs::file_size(path, ec);
+    if (ec) return false;
+    out = {path, sz, sz};
+    return true;
+}
+
+#endif
+
+} // namespace levin
@@ -1,9 +1,17 @@
 #include "disk_manager.h"
+#include "dir_scanner.h"
+#include "eviction_index.h"
 
 #include <algorithm>
 #include <random>
+#include <unordered_set>
 #include <vector>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace levin {
 
 DiskManager::DiskManager(uint64_t min_free_bytes, double min_free_pct, uint64_t max_storage)
@@ -50,39 +58,160 @@ DiskBudgetResult DiskManager::calculate(uint64_t fs_total, uint64_t fs_free,
     return DiskBudgetResult{budget, deficit, over_budget};
 }
 
-uint64_t DiskManager::delete_to_free(const std::filesystem::path& dir, uint64_t deficit_bytes) {
+bool can_punch_holes(const std::string& dir) {
+#ifdef __linux__
+    std::string probe = dir + "/.levin-punch-probe";
+    int fd = ::open(probe.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOFOLLOW, 0600);
+    if (fd < 0) return false;
+    char block[4096] = {};
+    bool ok = ::write(fd, block, sizeof(block)) == static_cast<ssize_t>(sizeof(block)) &&
+              ::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, sizeof(block)) == 0;
+    ::close(fd);
+    ::unlink(probe.c_str());
+    return ok;
+#else
+    (void)dir;
+    return false;
+#endif
+}
+
+bool punch_hole(const std::string& path, uint64_t offset, uint64_t length) {
+#ifdef __linux__
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) return false;
+    int rc = ::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                         static_cast<off_t>(offset), static_cast<off_t>(length));
+    ::close(fd);
+    return rc == 0;
+#else
+    (void)path;
+    (void)offset;
+    (void)length;
+    return false;
+#endif
+}
+
+// Delete shuffled files until `target` bytes are freed, adding to the
+// running totals. A file far larger than what is left goes to the shrinker
+// first. Each batch that would cover the rest of the target goes to the
+// evictor; what it doesn't take is unlinked here. Returns whether every
+// file went, or that the evictor aborted.
+DiskManager::Deleted DiskManager::delete_files(std::vector<ScannedFile>& files, uint64_t target,
+                                               uint64_t& freed, int* files_removed) const {
     namespace fs = std::filesystem;
 
-    if (deficit_bytes == 0) return 0;
+    std::random_device rd;
+    std::mt19937 rng(rd());
+    std::shuffle(files.begin(), files.end(), rng);
 
-    // Collect all regular files (recursive for multi-file torrents in subdirectories)
-    std::vector<fs::path> files;
-    std::error_code ec;
-    for (auto& entry : fs::recursive_directory_iterator(dir, ec)) {
-        if (entry.is_regular_file()) {
-            files.push_back(entry.path());
+    auto worth_shrinking = [this, target](const ScannedFile& f, uint64_t freed_so_far) {
+        return shrinker_ && f.allocated >= PARTIAL_EVICTION_MIN &&
+               f.allocated / PARTIAL_EVICTION_RATIO >= target - freed_so_far;
+    };
+
+    bool all = true;
+    size_t next = 0;
+    while (next < files.size() && freed < target) {
+        if (worth_shrinking(files[next], freed)) {
+            uint64_t shrunk = shrinker_(files[next].path, target - freed);
+            if (shrunk > 0) {
+                freed += shrunk;
+                if (on_freed_) on_freed_(shrunk, 0);
+                all = false;
+                next++;
+                continue;
+            }
+            // The shrinker passed; the batch below deletes it whole
+        }
+
+        // Up to the next file worth shrinking instead
+        size_t begin = next;
+        uint64_t planned = freed;
+        std::vector<std::string> batch;
+        while (next < files.size() && planned < target &&
+               (next == begin || !worth_shrinking(files[next], planned))) {
+            planned += files[next].allocated;
+            batch.push_back(files[next++].path);
+        }
+        std::optional<std::vector<std::string>> kept = evictor_ ? evictor_(batch) : std::move(batch);
+        if (!kept) return Deleted::ABORTED;
+        std::unordered_set<std::string> unlink_here(kept->begin(), kept->end());
+
+        std::error_code ec;
+        uint64_t batch_freed = 0;
+        int batch_removed = 0;
+        for (size_t i = begin; i < next; i++) {
+            const ScannedFile& f = files[i];
+            bool gone = !unlink_here.count(f.path) || (fs::remove(f.path, ec) && !ec);
+            if (gone) {
+                batch_freed += f.allocated;
+                if (f.size > 0) batch_removed++;
+            } else {
+                all = false;
+            }
         }
+        freed += batch_freed;
+        if (files_removed) *files_removed += batch_removed;
+        if (on_freed_ && (batch_freed > 0 || batch_removed > 0)) on_freed_(batch_freed, batch_removed);
     }
+    return all && next == files.size() ? Deleted::ALL : Deleted::SOME;
+}
 
-    if (files.empty()) return 0;
+// Remove `path` if it is a directory holding nothing but empty directories
+static void remove_empty_dirs(const std::filesystem::path& path) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_directory(fs::symlink_status(path, ec))) return;
+    for (const auto& entry : fs::directory_iterator(path, ec)) {
+        if (entry.is_directory(ec) && !entry.is_symlink(ec)) remove_empty_dirs(entry.path());
+    }
+    fs::remove(path, ec);  // fails, harmlessly, if anything is left
+}
 
-    // Shuffle for random deletion order per design doc
-    std::random_device rd;
-    std::mt19937 rng(rd());
-    std::shuffle(files.begin(), files.end(), rng);
+uint64_t DiskManager::delete_to_free(const std::filesystem::path& dir, uint64_t deficit_bytes,
+                                     int* files_removed) {
+    namespace fs = std::filesystem;
 
-    uint64_t freed = 0;
-    for (const auto& f : files) {
-        if (freed >= deficit_bytes) break;
+    if (files_removed) *files_removed = 0;
 
-        auto sz = fs::file_size(f, ec);
-        if (ec) continue;
+    if (deficit_bytes == 0) return 0;
 
-        if (fs::remove(f, ec) && !ec) {
-            freed += sz;
+    uint64_t freed = 0;
+    ScanOptions opts;
+    opts.collect_files = true;
+
+    // Least valuable torrents first; within one, files go in random order
+    // so a partly evicted torrent keeps a spread of its content
+    while (eviction_index_ && freed < deficit_bytes) {
+        auto victim = eviction_index_->next_victim();
+        if (!victim) break;
+
+        // A multi-file torrent's directory, or a single-file torrent
+        std::string path = (dir / *victim).string();
+        std::vector<ScannedFile> files = scan_directory(path, opts).files;
+        ScannedFile single;
+        if (files.empty() && scan_file(path, single)) files.push_back(std::move(single));
+
+        uint64_t before = freed;
+        Deleted deleted = delete_files(files, deficit_bytes, freed, files_removed);
+        if (deleted == Deleted::ABORTED) return freed;
+        if (deleted == Deleted::ALL) {
+            remove_empty_dirs(path);
+            eviction_index_->erase(*victim);
+        } else if (freed == before) {
+            // Nothing we can delete there; don't pick it again
+            eviction_index_->erase(*victim);
         }
     }
+    if (freed >= deficit_bytes) return freed;
 
+    // Collect all regular files (recursive for multi-file torrents in subdirectories)
+    std::vector<ScannedFile> files = scan_directory(dir.string(), opts).files;
+
+    if (files.empty()) return freed;
+
+    // Shuffle for random deletion order per design doc
+    delete_files(files, deficit_bytes, freed, files_removed);
     return freed;
 }
 
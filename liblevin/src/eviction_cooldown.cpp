@@ -0,0 +1,43 @@
+#include "eviction_cooldown.h"
+
+#include <algorithm>
+
+namespace levin {
+
+EvictionCooldown::EvictionCooldown(std::chrono::seconds window)
+    : base_(std::max(window, std::chrono::seconds(0))) {}
+
+void EvictionCooldown::record_eviction(uint64_t usage, TimePoint now) {
+    if (base_.count() == 0) return;
+    // Still cooling down, or not quiet for a window since
+    bool churn = evicted_ && now < until_ + window();
+    streak_ = churn ? std::min(streak_ + 1, MAX_DOUBLINGS) : 0;
+    evicted_ = true;
+    until_ = now + window();
+    ceiling_ = usage > margin() ? usage - margin() : 0;
+}
+
+uint64_t EvictionCooldown::cap_budget(uint64_t budget, uint64_t usage, TimePoint now) const {
+    if (!active(now)) return budget;
+    uint64_t room = ceiling_ > usage ? ceiling_ - usage : 0;
+    return std::min(budget, room);
+}
+
+bool EvictionCooldown::active(TimePoint now) const {
+    return evicted_ && now < until_;
+}
+
+std::chrono::seconds EvictionCooldown::remaining(TimePoint now) const {
+    if (!active(now)) return std::chrono::seconds(0);
+    return std::chrono::ceil<std::chrono::seconds>(until_ - now);
+}
+
+std::chrono::seconds EvictionCooldown::window() const {
+    return base_ * (1 << streak_);
+}
+
+uint64_t EvictionCooldown::margin() const {
+    return BASE_MARGIN << streak_;
+}
+
+} // namespace levin
@@ -0,0 +1,213 @@
+#include "eviction_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+namespace levin {
+
+// File format: header, then one record per entry.
+// Header: magic "LVEV" (4), version (4), entry count (8)
+// Record: log_demand (8), seeds (4), name length (4), name
+static const char MAGIC[4] = {'L', 'V', 'E', 'V'};
+static const uint32_t VERSION = 1;
+static const size_t HEADER_SIZE = 4 + 4 + 8;
+static const size_t RECORD_HEADER_SIZE = 8 + 4 + 4;
+
+template <typename T>
+static void put_raw(std::string& out, T v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <typename T>
+static bool get_raw(const std::string& in, size_t& off, T& v) {
+    if (off + sizeof(v) > in.size()) return false;
+    std::memcpy(&v, in.data() + off, sizeof(v));
+    off += sizeof(v);
+    return true;
+}
+
+// log2 of `units` accessed at `t`, weighted 2^(t / half-life). The weights
+// themselves overflow a double within a few years of the epoch; their
+// logarithms don't.
+static double log_weight(double units, int64_t t) {
+    return std::log2(units) + static_cast<double>(t) / EvictionIndex::HALF_LIFE_SECS;
+}
+
+// log2(2^a + 2^b) without leaving log space
+static double log_add(double a, double b) {
+    if (a < b) std::swap(a, b);
+    if (b == -std::numeric_limits<double>::infinity()) return a;
+    return a + std::log2(1.0 + std::exp2(b - a));
+}
+
+double EvictionIndex::rank_key(const Entry& e) {
+    return e.log_demand - std::log2(1.0 + std::max(0, e.seeds));
+}
+
+void EvictionIndex::put(const std::string& name, const Entry& e) {
+    auto it = entries_.find(name);
+    if (it != entries_.end()) {
+        ranking_.erase({rank_key(it->second), name});
+        it->second = e;
+    } else {
+        entries_.emplace(name, e);
+    }
+    ranking_.emplace(rank_key(e), name);
+}
+
+void EvictionIndex::add_demand(const std::string& name, double units, int64_t now) {
+    if (name.empty() || !(units > 0)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    Entry e;
+    if (it != entries_.end()) {
+        e = it->second;
+        e.log_demand = log_add(e.log_demand, log_weight(units, now));
+    } else {
+        // Unknown until now, so this is the first access we know of
+        e.log_demand = log_weight(units, now);
+    }
+    put(name, e);
+}
+
+void EvictionIndex::touch(const std::string& name, int64_t last_access) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    touch_locked(name, last_access);
+}
+
+void EvictionIndex::touch_locked(const std::string& name, int64_t last_access) {
+    if (name.empty() || entries_.count(name)) return;
+    Entry e;
+    e.log_demand = log_weight(1.0, last_access);
+    put(name, e);
+}
+
+void EvictionIndex::set_swarm_seeds(const std::string& name, int seeds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (it == entries_.end() || it->second.seeds == seeds) return;
+    Entry e = it->second;
+    e.seeds = seeds;
+    put(name, e);
+}
+
+void EvictionIndex::sync(const std::vector<TopLevelUsage>& entries) {
+    std::unordered_map<std::string, int64_t> found;
+    found.reserve(entries.size());
+    for (const auto& t : entries) found.emplace(t.name, t.newest_mtime);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (found.count(it->first)) {
+            ++it;
+        } else {
+            ranking_.erase({rank_key(it->second), it->first});
+            it = entries_.erase(it);
+        }
+    }
+    for (const auto& [name, mtime] : found) touch_locked(name, mtime);
+}
+
+void EvictionIndex::erase(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (it == entries_.end()) return;
+    ranking_.erase({rank_key(it->second), name});
+    entries_.erase(it);
+}
+
+std::optional<std::string> EvictionIndex::next_victim() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ranking_.empty()) return std::nullopt;
+    return ranking_.begin()->second;
+}
+
+double EvictionIndex::value(const std::string& name, int64_t now) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (it == entries_.end()) return -std::numeric_limits<double>::infinity();
+    return rank_key(it->second) - static_cast<double>(now) / HALF_LIFE_SECS;
+}
+
+size_t EvictionIndex::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+bool EvictionIndex::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.empty();
+}
+
+void EvictionIndex::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    ranking_.clear();
+}
+
+bool EvictionIndex::load(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) return false;
+    std::string buf((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    if (buf.size() < HEADER_SIZE || std::memcmp(buf.data(), MAGIC, 4) != 0) return false;
+
+    size_t off = 4;
+    uint32_t ver;
+    uint64_t count;
+    get_raw(buf, off, ver);
+    if (ver != VERSION) return false;
+    get_raw(buf, off, count);
+
+    EvictionIndex loaded;
+    for (uint64_t i = 0; i < count; i++) {
+        if (off + RECORD_HEADER_SIZE > buf.size()) return false;
+        Entry e;
+        int32_t seeds;
+        uint32_t name_len;
+        get_raw(buf, off, e.log_demand);
+        get_raw(buf, off, seeds);
+        get_raw(buf, off, name_len);
+        if (off + name_len > buf.size() || !std::isfinite(e.log_demand)) return false;
+        e.seeds = seeds;
+        loaded.put(buf.substr(off, name_len), e);
+        off += name_len;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.swap(loaded.entries_);
+    ranking_.swap(loaded.ranking_);
+    return true;
+}
+
+bool EvictionIndex::save(const std::string& path) const {
+    std::string buf;
+    buf.append(MAGIC, 4);
+    put_raw(buf, VERSION);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        put_raw(buf, static_cast<uint64_t>(entries_.size()));
+        for (const auto& [name, e] : entries_) {
+            put_raw(buf, e.log_demand);
+            put_raw(buf, static_cast<int32_t>(e.seeds));
+            put_raw(buf, static_cast<uint32_t>(name.size()));
+            buf.append(name);
+        }
+    }
+
+    // Write beside the old index, so a crash mid-write leaves it intact
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f.is_open()) return false;
+        f.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!f) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+} // namespace levin
@@ -0,0 +1,97 @@
+#include "eviction_worker.h"
+
+#include <utility>
+
+namespace levin {
+
+EvictionWorker::~EvictionWorker() {
+    stop();
+}
+
+void EvictionWorker::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    stopping_ = false;
+    thread_ = std::thread(&EvictionWorker::run, this);
+}
+
+void EvictionWorker::stop() {
+    std::deque<std::function<void(bool)>> declined;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        stopping_ = true;
+        declined.swap(owner_calls_);
+    }
+    cv_.notify_all();
+    for (auto& call : declined) call(false);
+    thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+    stopping_ = false;
+}
+
+bool EvictionWorker::running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void EvictionWorker::post(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_ && !stopping_) {
+            jobs_.push_back(std::move(job));
+            cv_.notify_one();
+            return;
+        }
+    }
+    job();
+}
+
+bool EvictionWorker::busy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !jobs_.empty() || active_ > 0;
+}
+
+void EvictionWorker::add_freed(uint64_t bytes, int files) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    freed_.bytes += bytes;
+    freed_.files += files;
+}
+
+EvictionWorker::Freed EvictionWorker::take_freed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Freed f = freed_;
+    freed_ = Freed{};
+    return f;
+}
+
+void EvictionWorker::run_owner_calls() {
+    std::deque<std::function<void(bool)>> calls;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls.swap(owner_calls_);
+    }
+    for (auto& call : calls) call(true);
+}
+
+void EvictionWorker::run() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            active_++;
+        }
+        job();
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_--;
+    }
+}
+
+} // namespace levin
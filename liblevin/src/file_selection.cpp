@@ -0,0 +1,55 @@
+#include "file_selection.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace levin {
+
+std::vector<int> file_availability(const std::vector<int64_t>& file_sizes,
+                                   int piece_length,
+                                   const std::vector<int>& piece_availability) {
+    std::vector<int> result(file_sizes.size(), 0);
+    if (piece_length <= 0) return result;
+
+    const int64_t num_pieces = static_cast<int64_t>(piece_availability.size());
+    int64_t offset = 0;
+    for (size_t i = 0; i < file_sizes.size(); i++) {
+        int64_t size = file_sizes[i];
+        if (size > 0) {
+            int64_t first = offset / piece_length;
+            int64_t last = (offset + size - 1) / piece_length;
+            if (last < num_pieces) {
+                int lowest = INT_MAX;
+                for (int64_t p = first; p <= last; p++) {
+                    lowest = std::min(lowest, piece_availability[static_cast<size_t>(p)]);
+                }
+                result[i] = std::max(lowest, 0);
+            }
+        }
+        offset += size;
+    }
+    return result;
+}
+
+std::vector<int> rank_rarest_first(const std::vector<int>& availability,
+                                   const std::vector<int>& base_order) {
+    std::vector<int> ranked;
+    ranked.reserve(base_order.size());
+    for (int idx : base_order) {
+        if (idx >= 0 && idx < static_cast<int>(availability.size())) ranked.push_back(idx);
+    }
+
+    auto key = [&availability](int idx) {
+        int a = availability[idx];
+        return a > 0 ? a : INT_MAX;
+    };
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [&key](int a, int b) { return key(a) < key(b); });
+    return ranked;
+}
+
+int swarm_seed_count(int scrape_complete, int connected_seeds) {
+    return scrape_complete >= 0 ? std::max(scrape_complete, connected_seeds) : connected_seeds;
+}
+
+} // namespace levin
@@ -0,0 +1,46 @@
+#include "info_hash.h"
+
+#include <algorithm>
+
+namespace levin {
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+InfoHash::InfoHash(const void* data, size_t size) {
+    size_ = static_cast<uint8_t>(std::min(size, V2_SIZE));
+    std::memcpy(bytes_.data(), data, size_);
+}
+
+std::optional<InfoHash> InfoHash::from_hex(std::string_view hex) {
+    if (hex.size() != 2 * V1_SIZE && hex.size() != 2 * V2_SIZE) return std::nullopt;
+    uint8_t buf[V2_SIZE];
+    for (size_t i = 0; i < hex.size() / 2; i++) {
+        int hi = hex_value(hex[2 * i]);
+        int lo = hex_value(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return std::nullopt;
+        buf[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return InfoHash(buf, hex.size() / 2);
+}
+
+void InfoHash::to_hex(char* out) const {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < size_; i++) {
+        out[2 * i] = digits[bytes_[i] >> 4];
+        out[2 * i + 1] = digits[bytes_[i] & 0xf];
+    }
+    out[2 * size_] = '\0';
+}
+
+std::string InfoHash::to_hex() const {
+    char buf[MAX_HEX + 1];
+    to_hex(buf);
+    return std::string(buf, 2 * size_);
+}
+
+} // namespace levin
@@ -0,0 +1,83 @@
+#include "io_profile.h"
+
+#include <filesystem>
+#include <fstream>
+
+#if defined(__linux__)
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace levin {
+
+static const int KiB = 1024;
+static const int MiB = 1024 * 1024;
+
+DiskIoSettings io_settings_for(IoProfile profile) {
+    switch (profile) {
+        case IoProfile::SD:
+            // Few, small writes in flight; write-through keeps the card from
+            // stalling on a large writeback burst
+            return {2, 1, DiskWriteMode::WRITE_THROUGH, 1 * MiB, 16 * KiB, 256 * KiB, 50};
+        case IoProfile::HDD:
+            // Fewer threads means fewer competing seeks; the page cache
+            // lets the kernel merge and reorder writes
+            return {4, 1, DiskWriteMode::OS_CACHE, 4 * MiB, 128 * KiB, 1 * MiB, 100};
+        case IoProfile::NVME:
+            return {16, 4, DiskWriteMode::OS_CACHE, 16 * MiB, 512 * KiB, 4 * MiB, 200};
+        case IoProfile::AUTO:
+        case IoProfile::SSD:
+            break;
+    }
+    return {8, 2, DiskWriteMode::OS_CACHE, 8 * MiB, 256 * KiB, 2 * MiB, 150};
+}
+
+IoProfile detect_io_profile(const std::string& path, const std::string& sysfs_root) {
+#if defined(__linux__)
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return IoProfile::SSD;
+
+    std::string dev_id = std::to_string(major(st.st_dev)) + ":" + std::to_string(minor(st.st_dev));
+    std::error_code ec;
+    fs::path dev = fs::canonical(fs::path(sysfs_root) / "dev" / "block" / dev_id, ec);
+    if (ec) return IoProfile::SSD;  // not a block device (tmpfs, overlay, ...)
+
+    // A partition has no queue/ of its own; its parent directory is the disk
+    fs::path disk = fs::exists(dev / "queue", ec) ? dev : dev.parent_path();
+    std::string name = disk.filename().string();
+    if (name.rfind("mmcblk", 0) == 0) return IoProfile::SD;
+    if (name.rfind("nvme", 0) == 0) return IoProfile::NVME;
+
+    std::ifstream f(disk / "queue" / "rotational");
+    int rotational = 0;
+    if (f >> rotational && rotational == 1) return IoProfile::HDD;
+    return IoProfile::SSD;
+#else
+    (void)path;
+    (void)sysfs_root;
+    return IoProfile::SSD;
+#endif
+}
+
+IoProfile parse_io_profile(const std::string& name) {
+    if (name == "sd") return IoProfile::SD;
+    if (name == "ssd") return IoProfile::SSD;
+    if (name == "hdd") return IoProfile::HDD;
+    if (name == "nvme") return IoProfile::NVME;
+    return IoProfile::AUTO;
+}
+
+const char* io_profile_name(IoProfile profile) {
+    switch (profile) {
+        case IoProfile::AUTO: return "auto";
+        case IoProfile::SD:   return "sd";
+        case IoProfile::SSD:  return "ssd";
+        case IoProfile::HDD:  return "hdd";
+        case IoProfile::NVME: return "nvme";
+    }
+    return "auto";
+}
+
+} // namespace levin
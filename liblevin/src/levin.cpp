@@ -1,21 +1,27 @@
 #include "liblevin.h"
 #include "state_machine.h"
 #include "disk_manager.h"
+#include "dir_scanner.h"
+#include "data_dir_tracker.h"
+#include "usage_snapshot.h"
+#include "eviction_index.h"
+#include "eviction_worker.h"
+#include "eviction_cooldown.h"
 #include "torrent_session.h"
 #include "torrent_watcher.h"
+#include "torrent_index.h"
 #include "annas_archive.h"
 #include "statistics.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
+#include <deque>
 #include <memory>
 #include <string>
 #include <filesystem>
-
-#if defined(__linux__) || defined(__APPLE__)
-#include <sys/stat.h>
-#endif
+#include <future>
 
 #include "levin_log.h"
 
@@ -36,15 +42,31 @@ struct levin_ctx {
     int disk_check_interval_secs;
     int max_download_kbps;
     int max_upload_kbps;
+    levin::FileSelection file_selection;
+    levin::IoProfile io_profile;
+    uint64_t memory_budget_bytes;
+    bool unload_inactive;
+    int pause_grace_secs;
+    int state_debounce_secs;
+    int state_min_dwell_secs;
+    bool track_data_directory;
+    int eviction_cooldown_secs;
 
     // Core components
     levin::StateMachine state_machine;
     levin::DiskManager disk_manager;
+    levin::DataDirTracker data_tracker;  // event-driven usage, when enabled and available
+    int64_t tracked_unseen = 0;          // on top of the tracker: data written without events
     std::unique_ptr<levin::ITorrentSession> session;
     std::unique_ptr<levin::TorrentWatcher> watcher;
+    levin::TorrentIndex torrent_index;  // parsed .torrent metadata, state_dir/torrents.idx
+    levin::EvictionIndex eviction_index;  // what to delete first, state_dir/eviction.idx
+    levin::EvictionWorker eviction_worker;  // runs delete_to_free() off the tick thread
+    levin::EvictionCooldown eviction_cooldown;  // holds the budget down after evicting
     levin::Statistics stats;
     uint64_t stats_base_downloaded = 0; // Cumulative total before this session
     uint64_t stats_base_uploaded = 0;
+    uint64_t stats_base_wasted = 0;
 
     // State tracking
     bool started = false;
@@ -64,9 +86,24 @@ struct levin_ctx {
     uint64_t disk_budget = 0;
     int over_budget = 0;
     int file_count = 0;
+    uint64_t eviction_pending = 0;  // deficit handed to the eviction worker, not yet freed
 
     // Tick counter for periodic disk checks
     int tick_count = 0;
+    int last_usage_scan_tick = 0;  // when disk_usage was last measured by a full walk
+    bool usage_known = false;      // disk_usage/file_count hold a full walk plus deltas
+    std::future<levin::DirScan> usage_walk;  // background walk in progress
+    levin::DiskUsageDelta walk_delta;        // changes counted since usage_walk started
+    levin::UsageSnapshot usage_snapshot;     // state_dir/usage.snap, as last saved
+    bool usage_entries_changed = false;      // a walk finished since the last save
+    bool eviction_running = false;           // a delete_to_free() job was posted
+    int soft_pause_ticks = 0;  // ticks spent soft-paused
+
+    // Staged startup: .torrent files found by levin_start(), added over the
+    // following ticks. Known seeds go first since they need no checking.
+    std::deque<std::string> startup_seeds;
+    std::deque<std::string> startup_rest;
+    int startup_total = 0;
 };
 
 // Map internal state to C API state
@@ -87,9 +124,18 @@ static void apply_state_actions(levin_t* ctx, levin::State new_state) {
 
     switch (new_state) {
         case levin::State::OFF:
-        case levin::State::PAUSED:
             ctx->session->pause_session();
             break;
+        case levin::State::PAUSED:
+            // Brief interruptions keep peers connected; levin_tick() pauses
+            // fully once the grace period has passed
+            if (ctx->pause_grace_secs > 0) {
+                ctx->session->soft_pause_session();
+                ctx->soft_pause_ticks = 0;
+            } else {
+                ctx->session->pause_session();
+            }
+            break;
         case levin::State::IDLE:
             ctx->session->resume_session();
             break;
@@ -99,79 +145,285 @@ static void apply_state_actions(levin_t* ctx, levin::State new_state) {
             break;
         case levin::State::DOWNLOADING:
             ctx->session->resume_session();
-            if (ctx->max_download_kbps > 0) {
-                ctx->session->set_download_rate_limit(ctx->max_download_kbps * 1024);
-            } else {
-                ctx->session->resume_downloads();
-            }
+            ctx->session->resume_downloads();
+            ctx->session->set_download_rate_limit(
+                ctx->max_download_kbps > 0 ? ctx->max_download_kbps * 1024 : 0);
             break;
     }
 }
 
-// Calculate current disk usage and count non-empty files in data directory
-struct DiskScan {
-    uint64_t usage;
-    int file_count;
-};
+// Between full walks, disk usage is kept as a running total of what the
+// session reports writing and what levin deletes. The walk still runs every
+// USAGE_RECONCILE_INTERVAL ticks, to pick up changes made by anything else.
+// Only the first walk without a snapshot blocks the tick; the rest run on a
+// background thread.
+static const int USAGE_RECONCILE_INTERVAL = 1800;
 
-static DiskScan calculate_disk_usage(const std::string& data_dir) {
-    DiskScan result{0, 0};
-    std::error_code ec;
-    if (!fs::exists(data_dir, ec)) return result;
-    for (auto& entry : fs::recursive_directory_iterator(data_dir, ec)) {
-        if (entry.is_regular_file()) {
-#if defined(__linux__) || defined(__APPLE__)
-            struct stat st;
-            if (::stat(entry.path().c_str(), &st) == 0) {
-                uint64_t size = static_cast<uint64_t>(st.st_blocks) * 512;
-                result.usage += size;
-                if (st.st_size > 0) result.file_count++;
-            }
-#else
-            auto sz = entry.file_size(ec);
-            result.usage += sz;
-            if (sz > 0) result.file_count++;
-#endif
-        }
+static std::string usage_snapshot_path(const levin_t* ctx) {
+    return ctx->state_directory + "/usage.snap";
+}
+
+static std::string eviction_index_path(const levin_t* ctx) {
+    return ctx->state_directory + "/eviction.idx";
+}
+
+static void save_usage_snapshot(levin_t* ctx) {
+    levin::UsageSnapshot& snap = ctx->usage_snapshot;
+    if (!ctx->usage_known && !ctx->data_tracker.active()) return;
+    if (!ctx->usage_entries_changed && snap.usage == ctx->disk_usage &&
+        snap.file_count == ctx->file_count) {
+        return;
     }
-    return result;
+    ctx->usage_entries_changed = false;
+    snap.data_directory = ctx->data_directory;
+    snap.usage = ctx->disk_usage;
+    snap.file_count = ctx->file_count;
+    snap.save(usage_snapshot_path(ctx));
 }
 
-static void do_disk_check(levin_t* ctx) {
-    auto scan = calculate_disk_usage(ctx->data_directory);
+// Trust the usage saved by the last run until a background walk confirms it
+static void load_usage_snapshot(levin_t* ctx) {
+    levin::UsageSnapshot& snap = ctx->usage_snapshot;
+    if (!snap.load(usage_snapshot_path(ctx)) || snap.data_directory != ctx->data_directory) {
+        snap = levin::UsageSnapshot{};
+        return;
+    }
+    ctx->disk_usage = snap.usage;
+    ctx->file_count = snap.file_count;
+    ctx->usage_known = true;
+    LEVIN_LOG("usage snapshot: %llu bytes in %d files, %d entries",
+              (unsigned long long)snap.usage, snap.file_count, (int)snap.entries.size());
+}
+
+// The walk may already have passed the changed files
+static void note_walk_delta(levin_t* ctx, int64_t bytes, int files) {
+    if (ctx->usage_walk.valid()) {
+        ctx->walk_delta.bytes += bytes;
+        ctx->walk_delta.files += files;
+    }
+}
+
+static void add_usage(levin_t* ctx, int64_t bytes, int files) {
+    int64_t usage = static_cast<int64_t>(ctx->disk_usage) + bytes;
+    ctx->disk_usage = usage > 0 ? static_cast<uint64_t>(usage) : 0;
+    ctx->file_count = std::max(0, ctx->file_count + files);
+    note_walk_delta(ctx, bytes, files);
+}
+
+static void start_usage_walk(levin_t* ctx) {
+    if (ctx->usage_walk.valid()) return;
+    levin::ScanOptions opts;
+    opts.by_top_level = true;
+    ctx->walk_delta = levin::DiskUsageDelta{};
+    ctx->usage_walk = std::async(std::launch::async, levin::scan_directory, ctx->data_directory, opts);
+    ctx->last_usage_scan_tick = ctx->tick_count;
+}
+
+// Adopt a finished walk plus whatever changed while it ran. Pieces written
+// to a directory after the walk read it are counted in both; the error is
+// bounded by what downloads during one walk and gone at the next.
+static void finish_usage_walk(levin_t* ctx, bool wait) {
+    if (!ctx->usage_walk.valid()) return;
+    if (!wait && ctx->usage_walk.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+    levin::DirScan scan = ctx->usage_walk.get();
+    uint64_t before = ctx->disk_usage;
     ctx->disk_usage = scan.usage;
     ctx->file_count = scan.file_count;
+    levin::DiskUsageDelta since = ctx->walk_delta;
+    add_usage(ctx, since.bytes, since.files);
+    ctx->usage_snapshot.entries = std::move(scan.top_level);
+    ctx->usage_entries_changed = true;
+    ctx->eviction_index.sync(ctx->usage_snapshot.entries);
+    if (ctx->data_tracker.active()) {
+        // Whatever the tracker missed is now counted by the walk
+        ctx->tracked_unseen = static_cast<int64_t>(ctx->disk_usage) -
+                              static_cast<int64_t>(ctx->data_tracker.usage());
+    }
+    if (ctx->disk_usage != before) {
+        LEVIN_LOG("disk usage reconciled: %llu -> %llu bytes",
+                  (unsigned long long)before, (unsigned long long)ctx->disk_usage);
+    }
+}
+
+// Take usage from the data directory tracker, if it is running. Its events
+// cover files coming and going, and what levin deleted, but not pieces
+// written through a memory map (libtorrent 2.x), which raise no events
+// until the file is closed; those are counted on top.
+static bool read_tracked_usage(levin_t* ctx) {
+    ctx->data_tracker.poll();
+    if (!ctx->data_tracker.active()) return false;
+    int64_t usage = static_cast<int64_t>(ctx->data_tracker.usage()) + ctx->tracked_unseen;
+    ctx->disk_usage = usage > 0 ? static_cast<uint64_t>(usage) : 0;
+    ctx->file_count = ctx->data_tracker.file_count();
+    ctx->usage_known = false;  // walk again should tracking stop
+    return true;
+}
+
+static bool reconcile_due(const levin_t* ctx, const levin::DiskUsageDelta& delta) {
+    return delta.rescan || ctx->tick_count - ctx->last_usage_scan_tick >= USAGE_RECONCILE_INTERVAL;
+}
+
+static void refresh_disk_usage(levin_t* ctx) {
+    levin::DiskUsageDelta delta = ctx->session ? ctx->session->take_disk_usage_delta()
+                                               : levin::DiskUsageDelta{};
+    if (ctx->data_tracker.active()) {
+        // Pieces are counted until the walk measures them. Once their file
+        // is closed the tracker sees them too, so until then usage reads
+        // high rather than low.
+        ctx->tracked_unseen += delta.bytes;
+        note_walk_delta(ctx, delta.bytes, 0);
+    }
+    if (read_tracked_usage(ctx)) {
+        finish_usage_walk(ctx, false);
+        if (reconcile_due(ctx, delta)) start_usage_walk(ctx);
+        return;
+    }
+    if (!ctx->usage_known) {
+        // Nothing to go on: measure now
+        start_usage_walk(ctx);
+        finish_usage_walk(ctx, true);
+        ctx->usage_known = true;
+        return;
+    }
+    add_usage(ctx, delta.bytes, delta.files);
+    finish_usage_walk(ctx, false);
+    if (reconcile_due(ctx, delta)) start_usage_walk(ctx);
+}
+
+static void reset_disk_manager(levin_t* ctx) {
+    ctx->disk_manager = levin::DiskManager(ctx->min_free_bytes, ctx->min_free_percentage, ctx->max_storage_bytes);
+    ctx->disk_manager.set_eviction_index(&ctx->eviction_index);
+    // Files of running torrents are deleted, or for huge ones shrunk,
+    // through the session, so it doesn't serve them from missing files or
+    // fetch them again. Deletion runs on the eviction worker; the session
+    // calls are run by the tick.
+    ctx->disk_manager.set_evictor([ctx](const std::vector<std::string>& paths) {
+        // Declined when stopping: abort, rather than delete behind the session's back
+        return ctx->eviction_worker.call_on_owner([ctx, &paths] {
+            if (!ctx->session || !ctx->session->is_running()) return paths;
+            return ctx->session->evict_files(paths);
+        });
+    });
+    ctx->disk_manager.set_shrinker([ctx](const std::string& path, uint64_t bytes) -> uint64_t {
+        auto shrunk = ctx->eviction_worker.call_on_owner([ctx, &path, bytes]() -> uint64_t {
+            if (!ctx->session || !ctx->session->is_running()) return 0;
+            return ctx->session->shrink_file(path, bytes);
+        });
+        return shrunk.value_or(0);
+    });
+}
+
+// Count what the eviction worker has freed since the last call
+static void collect_evictions(levin_t* ctx) {
+    levin::EvictionWorker::Freed freed = ctx->eviction_worker.take_freed();
+    if (freed.bytes == 0 && freed.files == 0) return;
+    ctx->fs_free += freed.bytes;
+    ctx->eviction_pending -= std::min(ctx->eviction_pending, freed.bytes);
+    if (read_tracked_usage(ctx)) {
+        note_walk_delta(ctx, -static_cast<int64_t>(freed.bytes), -freed.files);
+    } else {
+        add_usage(ctx, -static_cast<int64_t>(freed.bytes), -freed.files);
+    }
+}
+
+// Hand the deficit to the eviction worker. It deletes with its own copy of
+// the disk manager, reporting as it goes.
+static void start_eviction(levin_t* ctx, uint64_t deficit) {
+    // Keep what this frees free for a while; the window grows while
+    // evictions keep coming, and evicted files sit out just as long
+    ctx->eviction_cooldown.record_eviction(ctx->disk_usage, std::chrono::steady_clock::now());
+    ctx->session->set_eviction_cooldown(static_cast<int>(ctx->eviction_cooldown.window().count()));
+
+    levin::DiskManager dm = ctx->disk_manager;
+    levin::EvictionWorker* worker = &ctx->eviction_worker;
+    dm.set_freed_callback([worker](uint64_t bytes, int files) { worker->add_freed(bytes, files); });
+    ctx->eviction_pending = deficit;
+    ctx->eviction_running = true;
+    LEVIN_LOG("over budget, evicting %llu bytes", (unsigned long long)deficit);
+    worker->post([dm = std::move(dm), dir = ctx->data_directory, deficit]() mutable {
+        dm.delete_to_free(dir, deficit);
+    });
+}
+
+static void do_disk_check(levin_t* ctx) {
+    collect_evictions(ctx);
+    refresh_disk_usage(ctx);
     auto result = ctx->disk_manager.calculate(ctx->fs_total, ctx->fs_free, ctx->disk_usage);
+
+    // While the worker is still freeing space, hold the budget at zero
+    // rather than download into space it is about to need
+    bool evicting = ctx->eviction_worker.busy();
+    if (evicting) {
+        result.budget_bytes = 0;
+        result.over_budget = true;
+    } else if (!result.over_budget) {
+        // Just evicted: don't download straight back up to where that happened
+        result.budget_bytes = ctx->eviction_cooldown.cap_budget(result.budget_bytes, ctx->disk_usage,
+                                                                std::chrono::steady_clock::now());
+        if (result.budget_bytes == 0) result.over_budget = true;
+    }
     ctx->disk_budget = result.budget_bytes;
     ctx->over_budget = result.over_budget ? 1 : 0;
 
     ctx->state_machine.update_storage(!result.over_budget);
 
     // Set per-file download priorities so we never download more than the budget allows.
-    // Files that don't fit get priority 0 (don't download).
+    // Files that don't fit get priority 0 (don't download). Over budget this
+    // stops all downloading before anything is deleted.
     if (ctx->session) {
         ctx->session->apply_budget_priorities(result.budget_bytes);
     }
 
-    // Safety net: if somehow over budget (e.g. files added externally), delete to recover
-    if (result.over_budget && result.deficit_bytes > 0) {
-        uint64_t freed = ctx->disk_manager.delete_to_free(ctx->data_directory, result.deficit_bytes);
-        // Update fs_free to reflect freed space so recalculation is accurate
-        ctx->fs_free += freed;
-        // Recalculate after deletion
-        auto scan2 = calculate_disk_usage(ctx->data_directory);
-        ctx->disk_usage = scan2.usage;
-        ctx->file_count = scan2.file_count;
-        auto r2 = ctx->disk_manager.calculate(ctx->fs_total, ctx->fs_free, ctx->disk_usage);
-        ctx->disk_budget = r2.budget_bytes;
-        ctx->over_budget = r2.over_budget ? 1 : 0;
-        ctx->state_machine.update_storage(!r2.over_budget);
-
-        // Re-apply priorities with the updated budget
-        if (ctx->session) {
-            ctx->session->apply_budget_priorities(r2.budget_bytes);
+    // Safety net: if somehow over budget (e.g. files added externally), delete
+    // to recover. The worker deletes; the tick re-checks once it is done.
+    if (!evicting && result.over_budget && result.deficit_bytes > 0) {
+        start_eviction(ctx, result.deficit_bytes);
+    }
+
+    save_usage_snapshot(ctx);
+}
+
+// Feed the torrents queued by levin_start() to the session's parse pool.
+// Known seeds go in large batches; the rest are held to a bounded number in
+// flight so a cold start can't flood the pool ahead of newer additions.
+static void process_startup_queue(levin_t* ctx) {
+    static const int STARTUP_SEED_BATCH = 256;
+    static const int STARTUP_MAX_IN_FLIGHT = 64;
+
+    if (ctx->startup_seeds.empty() && ctx->startup_rest.empty()) return;
+
+    for (int i = 0; i < STARTUP_SEED_BATCH && !ctx->startup_seeds.empty(); i++) {
+        // In unload mode a known seed is registered from the index and
+        // resume data alone; the seeding scheduler loads it when needed
+        const std::string& path = ctx->startup_seeds.front();
+        if (!ctx->session->add_unloaded_torrent(path)) {
+            ctx->session->async_add_torrent(path);
         }
+        ctx->startup_seeds.pop_front();
     }
+    if (ctx->startup_seeds.empty()) {
+        while (!ctx->startup_rest.empty() &&
+               ctx->session->pending_adds() < STARTUP_MAX_IN_FLIGHT) {
+            ctx->session->async_add_torrent(ctx->startup_rest.front());
+            ctx->startup_rest.pop_front();
+        }
+    }
+
+    if (ctx->startup_seeds.empty() && ctx->startup_rest.empty()) {
+        LEVIN_LOG("staged startup complete, torrent_count=%d", ctx->session->torrent_count());
+        ctx->torrent_index.save();
+    }
+}
+
+static levin::IoProfile to_io_profile(levin_io_profile_t p) {
+    switch (p) {
+        case LEVIN_IO_PROFILE_SD:   return levin::IoProfile::SD;
+        case LEVIN_IO_PROFILE_SSD:  return levin::IoProfile::SSD;
+        case LEVIN_IO_PROFILE_HDD:  return levin::IoProfile::HDD;
+        case LEVIN_IO_PROFILE_NVME: return levin::IoProfile::NVME;
+        case LEVIN_IO_PROFILE_AUTO: break;
+    }
+    return levin::IoProfile::AUTO;
 }
 
 // --- C API Implementation ---
@@ -196,9 +448,20 @@ levin_t* levin_create(const levin_config_t* config) {
     ctx->disk_check_interval_secs = config->disk_check_interval_secs > 0 ? config->disk_check_interval_secs : 60;
     ctx->max_download_kbps = config->max_download_kbps;
     ctx->max_upload_kbps = config->max_upload_kbps;
+    ctx->file_selection = (config->file_selection == LEVIN_FILE_SELECTION_RAREST_FIRST)
+        ? levin::FileSelection::RAREST_FIRST : levin::FileSelection::RANDOM;
+    ctx->io_profile = to_io_profile(config->io_profile);
+    ctx->memory_budget_bytes = config->memory_budget_bytes;
+    ctx->unload_inactive = (config->unload_inactive != 0);
+    ctx->pause_grace_secs = config->pause_grace_secs > 0 ? config->pause_grace_secs : 0;
+    ctx->state_debounce_secs = config->state_debounce_secs > 0 ? config->state_debounce_secs : 0;
+    ctx->state_min_dwell_secs = config->state_min_dwell_secs > 0 ? config->state_min_dwell_secs : 0;
+    ctx->track_data_directory = (config->track_data_directory != 0);
+    ctx->eviction_cooldown_secs = config->eviction_cooldown_secs > 0 ? config->eviction_cooldown_secs : 0;
+    ctx->eviction_cooldown = levin::EvictionCooldown(std::chrono::seconds(ctx->eviction_cooldown_secs));
 
     // Initialize disk manager
-    ctx->disk_manager = levin::DiskManager(ctx->min_free_bytes, ctx->min_free_percentage, ctx->max_storage_bytes);
+    reset_disk_manager(ctx);
 
 #ifdef LEVIN_USE_STUB_SESSION
     ctx->session = std::make_unique<levin::StubTorrentSession>();
@@ -209,6 +472,17 @@ levin_t* levin_create(const levin_config_t* config) {
     // Create torrent watcher
     ctx->watcher = std::make_unique<levin::TorrentWatcher>();
 
+    // A loose charger or flapping Wi-Fi should not pause and resume the
+    // session each time: only battery/network changes that hold count, and
+    // once levin has stopped work it stays stopped for a while. OFF has no
+    // dwell: it is only reached by the user, and re-enabling acts at once.
+    std::chrono::seconds debounce(ctx->state_debounce_secs);
+    ctx->state_machine.set_debounce(levin::Condition::BATTERY, debounce);
+    ctx->state_machine.set_debounce(levin::Condition::NETWORK, debounce);
+    for (levin::State s : {levin::State::PAUSED, levin::State::IDLE, levin::State::SEEDING}) {
+        ctx->state_machine.set_min_dwell(s, std::chrono::seconds(ctx->state_min_dwell_secs));
+    }
+
     // Wire up state machine callback
     ctx->state_machine.set_callback([ctx](levin::State old_s, levin::State new_s) {
         apply_state_actions(ctx, new_s);
@@ -241,16 +515,57 @@ int levin_start(levin_t* ctx) {
     ctx->stats.load(ctx->state_directory + "/stats.dat");
     ctx->stats_base_downloaded = ctx->stats.total_downloaded;
     ctx->stats_base_uploaded = ctx->stats.total_uploaded;
+    ctx->stats_base_wasted = ctx->stats.total_wasted;
 
     // Start session (with state restoration)
     ctx->session->configure(6881, ctx->stun_server);
+    ctx->session->set_io_profile(ctx->io_profile);
+    ctx->session->set_memory_budget(ctx->memory_budget_bytes);
     ctx->session->load_state(ctx->state_directory + "/session.state");
+    ctx->session->set_resume_directory(ctx->state_directory + "/resume");
+    ctx->torrent_index.open(ctx->state_directory + "/torrents.idx");
+    ctx->session->set_metadata_index(&ctx->torrent_index);
+    ctx->eviction_index.load(eviction_index_path(ctx));
+    ctx->session->set_eviction_index(&ctx->eviction_index);
+    ctx->session->set_file_selection(ctx->file_selection);
+    ctx->session->set_unload_inactive(ctx->unload_inactive);
+    ctx->session->set_eviction_cooldown(ctx->eviction_cooldown_secs);
+    ctx->session->set_disk_job_runner([ctx](std::function<void()> job) {
+        ctx->eviction_worker.post(std::move(job));
+    });
     ctx->session->start(ctx->data_directory);
+    ctx->eviction_worker.start();
+
+    // Usage from the last run is good enough for the first budget; a
+    // background walk corrects it shortly after
+    load_usage_snapshot(ctx);
+    if (!ctx->usage_snapshot.entries.empty()) {
+        ctx->eviction_index.sync(ctx->usage_snapshot.entries);
+    }
+
+    if (ctx->track_data_directory) {
+        ctx->tracked_unseen = 0;
+        if (ctx->data_tracker.start(ctx->data_directory) == 0) {
+            LEVIN_LOG("tracking data directory, measuring it in the background");
+        } else {
+            LEVIN_LOG("data directory tracking unavailable, measuring usage periodically");
+        }
+    }
+    // The tracker's own measurement stands in for the confirming walk
+    if (ctx->usage_known && !ctx->data_tracker.measuring()) {
+        start_usage_walk(ctx);
+    }
 
     // Configure and start torrent watcher
     ctx->watcher->set_callbacks(
         [ctx](const std::string& path) {
-            levin_add_torrent(ctx, path.c_str());
+            // Parsed on the session's pool like the startup queue, so a
+            // large .torrent dropped in doesn't stall the tick
+            if (!ctx->session->async_add_torrent(path)) {
+                levin_add_torrent(ctx, path.c_str());
+            } else {
+                LEVIN_LOG("torrent queued: %s", path.c_str());
+            }
         },
         [ctx](const std::string& path) {
             // Extract filename to use as info_hash key for removal
@@ -269,8 +584,21 @@ int levin_start(levin_t* ctx) {
     if (!ctx->watch_directory.empty()) {
         LEVIN_LOG("starting watcher on: %s", ctx->watch_directory.c_str());
         ctx->watcher->start(ctx->watch_directory);
-        ctx->watcher->scan_existing();
-        LEVIN_LOG("scan_existing complete, torrent_count=%d", ctx->session->torrent_count());
+
+        // Don't add existing torrents here; levin_tick() adds them in batches
+        // so start returns (and the platform shell is reachable) right away.
+        auto existing = ctx->watcher->list_existing();
+        ctx->torrent_index.retain_only(existing);
+        for (auto& path : existing) {
+            if (ctx->session->is_known_seed(path)) {
+                ctx->startup_seeds.push_back(std::move(path));
+            } else {
+                ctx->startup_rest.push_back(std::move(path));
+            }
+        }
+        ctx->startup_total = static_cast<int>(ctx->startup_seeds.size() + ctx->startup_rest.size());
+        LEVIN_LOG("staged startup: %d torrents queued (%d known seeds)",
+                  ctx->startup_total, (int)ctx->startup_seeds.size());
     }
     return 0;
 }
@@ -278,15 +606,36 @@ int levin_start(levin_t* ctx) {
 void levin_stop(levin_t* ctx) {
     if (!ctx || !ctx->started) return;
     ctx->watcher->stop();
+    ctx->startup_seeds.clear();
+    ctx->startup_rest.clear();
 
     // Update and save statistics before stopping
     ctx->stats.update(ctx->stats_base_downloaded, ctx->stats_base_uploaded,
                       ctx->session->total_downloaded(), ctx->session->total_uploaded());
+    ctx->stats.update_wasted(ctx->stats_base_wasted, ctx->session->wasted_bytes());
     ctx->stats.save(ctx->state_directory + "/stats.dat");
 
+    // Finish deleting first; the session calls it waits on are declined
+    ctx->eviction_worker.stop();
+    collect_evictions(ctx);
+    ctx->eviction_running = false;
+    ctx->eviction_pending = 0;
+
     ctx->session->save_state(ctx->state_directory + "/session.state");
     ctx->session->stop();
+    ctx->session->set_disk_job_runner(nullptr);
+    ctx->session->set_metadata_index(nullptr);
+    ctx->session->set_eviction_index(nullptr);
+    ctx->torrent_index.save();
+    ctx->torrent_index.close();
+    finish_usage_walk(ctx, true);
+    save_usage_snapshot(ctx);
+    ctx->eviction_index.save(eviction_index_path(ctx));
+    ctx->eviction_index.clear();
+    ctx->data_tracker.stop();
     ctx->started = false;
+    ctx->usage_known = false;
+    ctx->usage_snapshot = levin::UsageSnapshot{};
 }
 
 void levin_tick(levin_t* ctx) {
@@ -294,14 +643,44 @@ void levin_tick(levin_t* ctx) {
 
     ctx->tick_count++;
 
+    // Refresh cached torrent status from session alerts
+    ctx->session->process_alerts();
+
+    // Continue staged startup
+    process_startup_queue(ctx);
+
     // Poll watcher for new/removed torrent files
     ctx->watcher->poll();
 
     // Update has_torrents based on session
     ctx->state_machine.update_has_torrents(ctx->session->torrent_count() > 0);
 
+    // Apply condition changes that have outlasted the debounce window
+    ctx->state_machine.tick();
+
+    // A soft pause that outlasts its grace period becomes a full pause
+    if (ctx->session->is_soft_paused() && ++ctx->soft_pause_ticks >= ctx->pause_grace_secs) {
+        LEVIN_LOG("paused for %d s, disconnecting peers", ctx->soft_pause_ticks);
+        ctx->session->pause_session();
+    }
+
+    // Keep status current between disk checks
+    if (ctx->data_tracker.active()) {
+        read_tracked_usage(ctx);
+    }
+
+    // Serve the eviction worker, and re-check as soon as it is done so
+    // downloading resumes without waiting for the next interval
+    ctx->eviction_worker.run_owner_calls();
+    collect_evictions(ctx);
+    bool eviction_done = ctx->eviction_running && !ctx->eviction_worker.busy();
+    if (eviction_done) {
+        ctx->eviction_running = false;
+        ctx->eviction_pending = 0;
+    }
+
     // Periodic disk check
-    if (ctx->tick_count % ctx->disk_check_interval_secs == 0 || ctx->tick_count == 1) {
+    if (ctx->tick_count % ctx->disk_check_interval_secs == 0 || ctx->tick_count == 1 || eviction_done) {
         if (ctx->fs_total > 0) {
             do_disk_check(ctx);
         }
@@ -312,7 +691,9 @@ void levin_tick(levin_t* ctx) {
     if (ctx->tick_count % STATS_SAVE_INTERVAL == 0) {
         ctx->stats.update(ctx->stats_base_downloaded, ctx->stats_base_uploaded,
                           ctx->session->total_downloaded(), ctx->session->total_uploaded());
+        ctx->stats.update_wasted(ctx->stats_base_wasted, ctx->session->wasted_bytes());
         ctx->stats.save(ctx->state_directory + "/stats.dat");
+        ctx->eviction_index.save(eviction_index_path(ctx));
     }
 }
 
@@ -355,7 +736,9 @@ int levin_add_torrent(levin_t* ctx, const char* torrent_path) {
 
 void levin_remove_torrent(levin_t* ctx, const char* info_hash) {
     if (!ctx || !ctx->started || !info_hash) return;
-    ctx->session->remove_torrent(info_hash);
+    auto hash = levin::InfoHash::from_hex(info_hash);
+    if (!hash) return;
+    ctx->session->remove_torrent(*hash);
     ctx->state_machine.update_has_torrents(ctx->session->torrent_count() > 0);
 }
 
@@ -368,15 +751,27 @@ levin_status_t levin_get_status(levin_t* ctx) {
     status.peer_count = ctx->session ? ctx->session->peer_count() : 0;
     status.download_rate = ctx->session ? ctx->session->download_rate() : 0;
     status.upload_rate = ctx->session ? ctx->session->upload_rate() : 0;
-    // Cumulative totals: base (from previous sessions) + current session
-    status.total_downloaded = ctx->stats_base_downloaded +
-        (ctx->session ? ctx->session->total_downloaded() : 0);
-    status.total_uploaded = ctx->stats_base_uploaded +
-        (ctx->session ? ctx->session->total_uploaded() : 0);
+    // Cumulative totals: base (from previous sessions) + session-wide counters
+    levin::SessionMetrics metrics = ctx->session ? ctx->session->session_metrics()
+                                                 : levin::SessionMetrics{};
+    status.total_downloaded = ctx->stats_base_downloaded + metrics.payload_recv_bytes;
+    status.total_uploaded = ctx->stats_base_uploaded + metrics.payload_sent_bytes;
+    status.disk_queued_bytes = metrics.disk_queued_bytes;
+    status.memory_budget = ctx->memory_budget_bytes;
+    status.memory_estimate = ctx->session ? ctx->session->memory_estimate() : 0;
+    status.soft_paused = ctx->session && ctx->session->is_soft_paused() ? 1 : 0;
+    status.suppressed_transitions = ctx->state_machine.suppressed_transitions();
     status.disk_usage = ctx->disk_usage;
     status.disk_budget = ctx->disk_budget;
     status.over_budget = ctx->over_budget;
     status.file_count = ctx->file_count;
+    status.eviction_pending = ctx->eviction_pending;
+    status.wasted_bytes = ctx->stats_base_wasted + (ctx->session ? ctx->session->wasted_bytes() : 0);
+    status.eviction_cooldown_secs = static_cast<int>(
+        ctx->eviction_cooldown.remaining(std::chrono::steady_clock::now()).count());
+    status.startup_pending = static_cast<int>(ctx->startup_seeds.size() + ctx->startup_rest.size()) +
+        (ctx->session ? ctx->session->pending_adds() : 0);
+    status.startup_total = ctx->startup_total;
 
     return status;
 }
@@ -388,6 +783,25 @@ levin_torrent_t* levin_get_torrents(levin_t* ctx, int* count) {
     }
 
     auto torrents = ctx->session->get_torrent_list();
+
+    // Torrents still waiting in the startup queue are listed from the
+    // metadata index, without parsing them
+    auto add_queued = [&](const std::deque<std::string>& queue, bool seed) {
+        for (const auto& path : queue) {
+            auto meta = ctx->torrent_index.find(path);
+            if (!meta) continue;
+            levin::TorrentInfo t{};
+            t.info_hash = meta->info_hash;
+            t.name = meta->name;
+            t.size = meta->total_size;
+            t.is_seed = seed;
+            t.progress = seed ? 1.0 : 0.0;
+            torrents.push_back(std::move(t));
+        }
+    };
+    add_queued(ctx->startup_seeds, true);
+    add_queued(ctx->startup_rest, false);
+
     int n = static_cast<int>(torrents.size());
     if (n == 0) {
         *count = 0;
@@ -397,9 +811,8 @@ levin_torrent_t* levin_get_torrents(levin_t* ctx, int* count) {
     auto* list = new levin_torrent_t[n];
     for (int i = 0; i < n; i++) {
         const auto& t = torrents[i];
-        // Copy info_hash (truncate/pad to 40 chars)
         std::memset(list[i].info_hash, 0, sizeof(list[i].info_hash));
-        std::strncpy(list[i].info_hash, t.info_hash.c_str(), 40);
+        t.info_hash.to_hex(list[i].info_hash);
         list[i].name = strdup(t.name.c_str());
         list[i].size = t.size;
         list[i].downloaded = t.downloaded;
@@ -467,7 +880,9 @@ void levin_set_disk_limits(levin_t* ctx, uint64_t min_free_bytes, double min_fre
     ctx->min_free_bytes = min_free_bytes;
     ctx->min_free_percentage = min_free_pct;
     ctx->max_storage_bytes = max_storage_bytes;
-    ctx->disk_manager = levin::DiskManager(min_free_bytes, min_free_pct, max_storage_bytes);
+    reset_disk_manager(ctx);
+    // The last eviction point says nothing about the new limits
+    ctx->eviction_cooldown = levin::EvictionCooldown(std::chrono::seconds(ctx->eviction_cooldown_secs));
     // Trigger immediate re-evaluation
     if (ctx->started && ctx->fs_total > 0) {
         do_disk_check(ctx);
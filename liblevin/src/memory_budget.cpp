@@ -0,0 +1,59 @@
+#include "memory_budget.h"
+
+#include <algorithm>
+
+namespace levin {
+
+static int clamp_int(uint64_t v, int lo, int hi) {
+    if (hi < lo) hi = lo;
+    if (v < static_cast<uint64_t>(lo)) return lo;
+    if (v > static_cast<uint64_t>(hi)) return hi;
+    return static_cast<int>(v);
+}
+
+MemorySettings derive_memory_settings(uint64_t budget_bytes, int torrents, int active_torrents,
+                                      const DiskIoSettings& io) {
+    if (budget_bytes == 0) {
+        return {200, 3000, 1000, 2000,
+                io.max_queued_disk_bytes, io.send_buffer_low_watermark, io.send_buffer_watermark};
+    }
+
+    uint64_t loaded = static_cast<uint64_t>(std::max(torrents, 0));
+    uint64_t active = static_cast<uint64_t>(std::max(active_torrents, 1));
+    uint64_t paused = std::max<uint64_t>(loaded > active ? loaded - active : 0, 1);
+
+    // Fixed costs first; what's left is split between the tunable pools
+    uint64_t fixed = MemoryCosts::BASE + loaded * MemoryCosts::PER_TORRENT;
+    uint64_t avail = budget_bytes > fixed ? budget_bytes - fixed : 0;
+
+    MemorySettings s;
+    // 1/8 disk write queue
+    s.max_queued_disk_bytes = clamp_int(avail / 8, 256 * 1024, io.max_queued_disk_bytes);
+
+    // 1/8 peer lists, mostly for started torrents
+    uint64_t peer_share = avail / 8;
+    s.max_peerlist_size = clamp_int(peer_share * 3 / 4 / (MemoryCosts::PER_PEER_ENTRY * active), 50, 3000);
+    s.max_paused_peerlist_size = clamp_int(peer_share / 4 / (MemoryCosts::PER_PEER_ENTRY * paused), 10, 1000);
+
+    // 1/32 alert queue
+    s.alert_queue_size = clamp_int(avail / 32 / MemoryCosts::PER_ALERT, 500, 2000);
+
+    // The rest to peer connections and their send buffers
+    s.send_buffer_watermark = clamp_int(avail / 1024, 32 * 1024, io.send_buffer_watermark);
+    s.send_buffer_low_watermark = std::min(io.send_buffer_low_watermark, s.send_buffer_watermark / 4);
+    uint64_t conn_share = avail - avail / 8 - peer_share - avail / 32;
+    uint64_t per_conn = MemoryCosts::PER_CONNECTION + static_cast<uint64_t>(s.send_buffer_watermark);
+    s.connections_limit = clamp_int(conn_share / per_conn, 10, 200);
+    return s;
+}
+
+uint64_t estimate_memory_usage(int torrents, int connections, uint64_t disk_queued_bytes,
+                               const MemorySettings& settings) {
+    uint64_t per_conn = MemoryCosts::PER_CONNECTION + static_cast<uint64_t>(settings.send_buffer_watermark);
+    return MemoryCosts::BASE
+        + static_cast<uint64_t>(std::max(torrents, 0)) * MemoryCosts::PER_TORRENT
+        + static_cast<uint64_t>(std::max(connections, 0)) * per_conn
+        + disk_queued_bytes;
+}
+
+} // namespace levin
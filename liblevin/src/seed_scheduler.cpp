@@ -0,0 +1,62 @@
+#include "seed_scheduler.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace levin {
+
+// A leecher with no other seed is worth about this much measured upload
+static const double LEECHER_WEIGHT = 4.0 * 1024;
+
+double seed_demand_score(const SeedCandidate& c) {
+    double leechers = static_cast<double>(std::max(c.leechers, 0));
+    double seeds = static_cast<double>(std::max(c.seeds, 0));
+    return c.upload_rate + LEECHER_WEIGHT * leechers / (seeds + 1.0);
+}
+
+std::vector<bool> choose_active_seeds(const std::vector<SeedCandidate>& candidates,
+                                      int slots, int probe_slots) {
+    const size_t n = candidates.size();
+    std::vector<bool> chosen(n, false);
+    if (slots <= 0) return chosen;
+    if (n <= static_cast<size_t>(slots)) {
+        std::fill(chosen.begin(), chosen.end(), true);
+        return chosen;
+    }
+
+    probe_slots = std::clamp(probe_slots, 0, slots);
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    // Probe slots first: inactive torrents that have waited longest
+    std::vector<size_t> idle;
+    for (size_t i : order) {
+        if (!candidates[i].active) idle.push_back(i);
+    }
+    std::stable_sort(idle.begin(), idle.end(), [&candidates](size_t a, size_t b) {
+        return candidates[a].idle_secs > candidates[b].idle_secs;
+    });
+    int used = 0;
+    for (size_t i : idle) {
+        if (used >= probe_slots) break;
+        chosen[i] = true;
+        used++;
+    }
+
+    // Remaining slots by demand; incumbents win ties so equal scores don't churn
+    std::stable_sort(order.begin(), order.end(), [&candidates](size_t a, size_t b) {
+        double sa = seed_demand_score(candidates[a]);
+        double sb = seed_demand_score(candidates[b]);
+        if (sa != sb) return sa > sb;
+        return candidates[a].active && !candidates[b].active;
+    });
+    for (size_t i : order) {
+        if (used >= slots) break;
+        if (chosen[i]) continue;
+        chosen[i] = true;
+        used++;
+    }
+    return chosen;
+}
+
+} // namespace levin
@@ -3,12 +3,13 @@
 namespace levin {
 
 StateMachine::StateMachine()
+    : StateMachine([] { return std::chrono::steady_clock::now(); })
+{
+}
+
+StateMachine::StateMachine(StateClock clock)
     : current_state_(State::OFF)
-    , enabled_(false)
-    , battery_ok_(false)
-    , network_ok_(false)
-    , has_torrents_(false)
-    , storage_ok_(false)
+    , clock_(std::move(clock))
     , callback_(nullptr)
 {
 }
@@ -18,61 +19,116 @@ State StateMachine::state() const {
 }
 
 void StateMachine::update_enabled(bool enabled) {
-    if (enabled_ == enabled) return;
-    enabled_ = enabled;
-    evaluate();
+    update(Condition::ENABLED, enabled);
 }
 
 void StateMachine::update_battery(bool ok) {
-    if (battery_ok_ == ok) return;
-    battery_ok_ = ok;
-    evaluate();
+    update(Condition::BATTERY, ok);
 }
 
 void StateMachine::update_network(bool ok) {
-    if (network_ok_ == ok) return;
-    network_ok_ = ok;
-    evaluate();
+    update(Condition::NETWORK, ok);
 }
 
 void StateMachine::update_has_torrents(bool has) {
-    if (has_torrents_ == has) return;
-    has_torrents_ = has;
-    evaluate();
+    update(Condition::HAS_TORRENTS, has);
 }
 
 void StateMachine::update_storage(bool ok) {
-    if (storage_ok_ == ok) return;
-    storage_ok_ = ok;
-    evaluate();
+    update(Condition::STORAGE, ok);
 }
 
 void StateMachine::set_callback(StateCallback cb) {
     callback_ = std::move(cb);
 }
 
-void StateMachine::evaluate() {
-    // Priority-ordered evaluation per design doc
-    State new_state;
-
-    if (!enabled_) {
-        new_state = State::OFF;
-    } else if (!battery_ok_ || !network_ok_) {
-        new_state = State::PAUSED;
-    } else if (!has_torrents_) {
-        new_state = State::IDLE;
-    } else if (!storage_ok_) {
-        new_state = State::SEEDING;
-    } else {
-        new_state = State::DOWNLOADING;
+void StateMachine::set_debounce(Condition c, std::chrono::milliseconds window) {
+    input(c).debounce = window;
+}
+
+void StateMachine::set_min_dwell(State s, std::chrono::milliseconds dwell) {
+    min_dwell_[static_cast<size_t>(s)] = dwell;
+}
+
+void StateMachine::tick() {
+    TimePoint now = clock_();
+    settle(now);
+    evaluate(now);
+}
+
+uint64_t StateMachine::suppressed_transitions() const {
+    return suppressed_;
+}
+
+void StateMachine::update(Condition c, bool value) {
+    Input& in = input(c);
+    TimePoint now = clock_();
+    if (!in.known) {
+        in.known = true;
+        in.value = value;
+        evaluate(now);
+        return;
+    }
+    if (in.value == value) {
+        // Flipped back inside the window: the change never happened
+        if (in.pending) {
+            in.pending = false;
+            suppressed_++;
+        }
+        return;
     }
 
-    if (new_state != current_state_) {
-        State old = current_state_;
-        current_state_ = new_state;
-        if (callback_) {
-            callback_(old, new_state);
+    if (!in.pending) {
+        in.pending = true;
+        in.pending_since = now;
+    }
+    settle(now);
+    evaluate(now);
+}
+
+void StateMachine::settle(TimePoint now) {
+    for (Input& in : inputs_) {
+        if (in.pending && now - in.pending_since >= in.debounce) {
+            in.value = !in.value;
+            in.pending = false;
+        }
+    }
+}
+
+State StateMachine::target_state() const {
+    // Priority-ordered evaluation per design doc
+    if (!value(Condition::ENABLED)) return State::OFF;
+    if (!value(Condition::BATTERY) || !value(Condition::NETWORK)) return State::PAUSED;
+    if (!value(Condition::HAS_TORRENTS)) return State::IDLE;
+    if (!value(Condition::STORAGE)) return State::SEEDING;
+    return State::DOWNLOADING;
+}
+
+void StateMachine::evaluate(TimePoint now) {
+    State new_state = target_state();
+
+    if (new_state == current_state_) {
+        if (deferred_) {
+            deferred_ = false;
+            suppressed_++;
         }
+        return;
+    }
+
+    // Moving down (stopping work) is immediate; moving back up waits out
+    // the dwell time of the state we dropped to
+    bool moving_up = new_state > current_state_;
+    if (moving_up && now < hold_until_) {
+        deferred_ = true;
+        return;
+    }
+    deferred_ = false;
+    hold_until_ = moving_up ? TimePoint{} : now + min_dwell_[static_cast<size_t>(new_state)];
+
+    State old = current_state_;
+    current_state_ = new_state;
+    if (callback_) {
+        callback_(old, new_state);
     }
 }
 
@@ -1,14 +1,17 @@
 #include "statistics.h"
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 
 namespace levin {
 
-// File format: simple binary header + two uint64_t values.
-// Magic: "LVST" (4 bytes), version: 1 (4 bytes), then total_downloaded (8), total_uploaded (8).
+// File format: simple binary header + three uint64_t values.
+// Magic: "LVST" (4 bytes), version: 2 (4 bytes), then total_downloaded (8),
+// total_uploaded (8), total_wasted (8). Version 1 files stop before total_wasted.
 static const char MAGIC[4] = {'L', 'V', 'S', 'T'};
-static const uint32_t VERSION = 1;
-static const size_t FILE_SIZE = 4 + 4 + 8 + 8; // 24 bytes
+static const uint32_t VERSION = 2;
+static const size_t FILE_SIZE_V1 = 4 + 4 + 8 + 8; // 24 bytes
+static const size_t FILE_SIZE = FILE_SIZE_V1 + 8;  // 32 bytes
 
 bool Statistics::load(const std::string& path) {
     FILE* f = std::fopen(path.c_str(), "rb");
@@ -18,15 +21,17 @@ bool Statistics::load(const std::string& path) {
     size_t n = std::fread(buf, 1, FILE_SIZE, f);
     std::fclose(f);
 
-    if (n != FILE_SIZE) return false;
+    if (n < FILE_SIZE_V1) return false;
     if (std::memcmp(buf, MAGIC, 4) != 0) return false;
 
     uint32_t ver;
     std::memcpy(&ver, buf + 4, 4);
-    if (ver != VERSION) return false;
+    if (ver == 1 ? n != FILE_SIZE_V1 : (ver != VERSION || n != FILE_SIZE)) return false;
 
     std::memcpy(&total_downloaded, buf + 8, 8);
     std::memcpy(&total_uploaded, buf + 16, 8);
+    total_wasted = 0;
+    if (ver == VERSION) std::memcpy(&total_wasted, buf + 24, 8);
 
     return true;
 }
@@ -41,6 +46,7 @@ bool Statistics::save(const std::string& path) const {
     std::memcpy(buf + 4, &ver, 4);
     std::memcpy(buf + 8, &total_downloaded, 8);
     std::memcpy(buf + 16, &total_uploaded, 8);
+    std::memcpy(buf + 24, &total_wasted, 8);
 
     size_t n = std::fwrite(buf, 1, FILE_SIZE, f);
     std::fclose(f);
@@ -52,8 +58,12 @@ void Statistics::update(uint64_t base_downloaded, uint64_t base_uploaded,
                         uint64_t current_session_downloaded, uint64_t current_session_uploaded) {
     session_downloaded = current_session_downloaded;
     session_uploaded = current_session_uploaded;
-    total_downloaded = base_downloaded + current_session_downloaded;
-    total_uploaded = base_uploaded + current_session_uploaded;
+    total_downloaded = std::max(total_downloaded, base_downloaded + current_session_downloaded);
+    total_uploaded = std::max(total_uploaded, base_uploaded + current_session_uploaded);
+}
+
+void Statistics::update_wasted(uint64_t base_wasted, uint64_t current_session_wasted) {
+    total_wasted = std::max(total_wasted, base_wasted + current_session_wasted);
 }
 
 } // namespace levin
@@ -1,7 +1,6 @@
 #include "torrent_session.h"
+#include <cstring>
 #include <functional>
-#include <sstream>
-#include <iomanip>
 
 namespace levin {
 
@@ -15,25 +14,33 @@ void StubTorrentSession::start(const std::string& /*data_directory*/) {
 void StubTorrentSession::stop() {
     running_ = false;
     paused_ = false;
+    soft_paused_ = false;
 }
 
 bool StubTorrentSession::is_running() const { return running_; }
 
-std::optional<std::string> StubTorrentSession::add_torrent(const std::string& torrent_path) {
+void StubTorrentSession::process_alerts() {}
+
+std::optional<InfoHash> StubTorrentSession::add_torrent(const std::string& torrent_path) {
     if (!running_) return std::nullopt;
     torrent_count_++;
     // Generate a fake info hash from the path
-    std::hash<std::string> hasher;
-    auto h = hasher(torrent_path);
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0') << std::setw(16) << h;
-    std::string hex = oss.str();
-    // Pad to 40 hex chars
-    while (hex.size() < 40) hex += "0";
-    return hex.substr(0, 40);
+    uint8_t bytes[InfoHash::V1_SIZE] = {};
+    size_t h = std::hash<std::string>{}(torrent_path);
+    std::memcpy(bytes, &h, sizeof(h));
+    return InfoHash(bytes, sizeof(bytes));
+}
+
+bool StubTorrentSession::async_add_torrent(const std::string& torrent_path) {
+    return add_torrent(torrent_path).has_value();
 }
 
-void StubTorrentSession::remove_torrent(const std::string& /*info_hash*/) {
+int StubTorrentSession::pending_adds() const { return 0; }
+
+bool StubTorrentSession::is_known_seed(const std::string& /*torrent_path*/) const { return false; }
+bool StubTorrentSession::add_unloaded_torrent(const std::string& /*torrent_path*/) { return false; }
+
+void StubTorrentSession::remove_torrent(const InfoHash& /*info_hash*/) {
     if (torrent_count_ > 0) torrent_count_--;
 }
 
@@ -42,11 +49,14 @@ int StubTorrentSession::torrent_count() const { return torrent_count_; }
 std::vector<TorrentInfo> StubTorrentSession::get_torrent_list() const { return {}; }
 
 void StubTorrentSession::pause_session() { paused_ = true; }
-void StubTorrentSession::resume_session() { paused_ = false; }
+void StubTorrentSession::resume_session() { paused_ = false; soft_paused_ = false; }
 bool StubTorrentSession::is_paused() const { return paused_; }
+void StubTorrentSession::soft_pause_session() { if (running_ && !paused_) soft_paused_ = true; }
+bool StubTorrentSession::is_soft_paused() const { return soft_paused_ && !paused_; }
 
-void StubTorrentSession::pause_downloads() { download_rate_limit_ = 1; }
-void StubTorrentSession::resume_downloads() { download_rate_limit_ = 0; }
+void StubTorrentSession::pause_downloads() { downloads_paused_ = true; }
+void StubTorrentSession::resume_downloads() { downloads_paused_ = false; }
+bool StubTorrentSession::downloads_paused() const { return downloads_paused_; }
 void StubTorrentSession::set_download_rate_limit(int bps) { download_rate_limit_ = bps; }
 void StubTorrentSession::set_upload_rate_limit(int bps) { upload_rate_limit_ = bps; }
 int StubTorrentSession::get_download_rate_limit() const { return download_rate_limit_; }
@@ -56,15 +66,34 @@ int StubTorrentSession::download_rate() const { return 0; }
 int StubTorrentSession::upload_rate() const { return 0; }
 uint64_t StubTorrentSession::total_downloaded() const { return 0; }
 uint64_t StubTorrentSession::total_uploaded() const { return 0; }
+uint64_t StubTorrentSession::wasted_bytes() const { return 0; }
+SessionMetrics StubTorrentSession::session_metrics() const { return {}; }
+uint64_t StubTorrentSession::memory_estimate() const { return 0; }
+DiskUsageDelta StubTorrentSession::take_disk_usage_delta() { return {}; }
 
 bool StubTorrentSession::is_webtorrent_enabled() const { return false; }
-std::vector<std::string> StubTorrentSession::get_trackers(const std::string& /*info_hash*/) const {
+std::vector<std::string> StubTorrentSession::get_trackers(const InfoHash& /*info_hash*/) const {
     return {};
 }
 
 void StubTorrentSession::apply_budget_priorities(uint64_t /*budget_bytes*/) {}
+void StubTorrentSession::set_file_selection(FileSelection /*mode*/) {}
+std::vector<std::string> StubTorrentSession::evict_files(const std::vector<std::string>& paths) {
+    return paths;
+}
+uint64_t StubTorrentSession::shrink_file(const std::string& /*path*/, uint64_t /*bytes*/) {
+    return 0;
+}
+void StubTorrentSession::set_disk_job_runner(DiskJobRunner /*runner*/) {}
+void StubTorrentSession::set_eviction_cooldown(int /*secs*/) {}
+void StubTorrentSession::set_unload_inactive(bool /*enabled*/) {}
+void StubTorrentSession::set_io_profile(IoProfile /*profile*/) {}
+void StubTorrentSession::set_memory_budget(uint64_t /*bytes*/) {}
 
 void StubTorrentSession::save_state(const std::string& /*path*/) {}
 void StubTorrentSession::load_state(const std::string& /*path*/) {}
+void StubTorrentSession::set_resume_directory(const std::string& /*dir*/) {}
+void StubTorrentSession::set_metadata_index(TorrentIndex* /*index*/) {}
+void StubTorrentSession::set_eviction_index(EvictionIndex* /*index*/) {}
 
 } // namespace levin
@@ -0,0 +1,270 @@
+#include "torrent_index.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace levin {
+
+// File format (native endianness; the index is a local cache, not an exchange format):
+//   "LVIX" (4 bytes), version (4), entry count (8)
+//   then per entry: RecordHeader, path bytes, name bytes, file_count x uint64 file sizes.
+// record_len covers the whole entry, so readers can skip entries without parsing them.
+static const char MAGIC[4] = {'L', 'V', 'I', 'X'};
+static const uint32_t VERSION = 2;
+static const size_t FILE_HEADER_SIZE = 4 + 4 + 8;
+
+namespace {
+
+struct RecordHeader {
+    uint32_t record_len;
+    uint32_t file_count;
+    int64_t  mtime;
+    uint64_t torrent_size;  // size of the .torrent file, for staleness checks
+    uint64_t total_size;
+    uint32_t piece_length;
+    uint16_t path_len;
+    uint16_t name_len;
+    uint8_t  hash_len;      // 20 (v1) or 32 (v2)
+    uint8_t  reserved[7];
+    uint8_t  hash[32];
+};
+
+void append_record(std::string& out, const std::string& path, int64_t mtime,
+                   uint64_t torrent_size, const TorrentMetadata& meta) {
+    RecordHeader rh{};
+    rh.file_count = static_cast<uint32_t>(meta.file_sizes.size());
+    rh.mtime = mtime;
+    rh.torrent_size = torrent_size;
+    rh.total_size = meta.total_size;
+    rh.piece_length = meta.piece_length;
+    rh.path_len = static_cast<uint16_t>(path.size());
+    rh.name_len = static_cast<uint16_t>(std::min<size_t>(meta.name.size(), UINT16_MAX));
+    rh.hash_len = static_cast<uint8_t>(meta.info_hash.size());
+    std::memcpy(rh.hash, meta.info_hash.data(), rh.hash_len);
+    rh.record_len = static_cast<uint32_t>(sizeof(RecordHeader) + rh.path_len + rh.name_len +
+                                          rh.file_count * sizeof(uint64_t));
+
+    out.append(reinterpret_cast<const char*>(&rh), sizeof(rh));
+    out.append(path);
+    out.append(meta.name, 0, rh.name_len);
+    out.append(reinterpret_cast<const char*>(meta.file_sizes.data()),
+               meta.file_sizes.size() * sizeof(uint64_t));
+}
+
+} // anonymous namespace
+
+TorrentIndex::~TorrentIndex() {
+    close();
+}
+
+bool TorrentIndex::open(const std::string& path) {
+    close();
+    path_ = path;
+
+#if defined(__linux__) || defined(__APPLE__)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return errno == ENOENT;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size > 0) {
+        void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            map_ = static_cast<const uint8_t*>(p);
+            map_size_ = static_cast<size_t>(st.st_size);
+        }
+    }
+    ::close(fd);
+    if (!map_ && st.st_size > 0) return false;
+#else
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) return true;
+    fallback_.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    map_ = fallback_.data();
+    map_size_ = fallback_.size();
+#endif
+
+    if (!parse_mapped()) {
+        // Corrupt or old format: start over, the next save() replaces it
+        entries_.clear();
+        dirty_ = true;
+    }
+    return true;
+}
+
+void TorrentIndex::close() {
+#if defined(__linux__) || defined(__APPLE__)
+    if (map_) ::munmap(const_cast<uint8_t*>(map_), map_size_);
+#endif
+    map_ = nullptr;
+    map_size_ = 0;
+    fallback_.clear();
+    entries_.clear();
+    dirty_ = false;
+}
+
+bool TorrentIndex::parse_mapped() {
+    if (map_size_ == 0) return true;
+    if (map_size_ < FILE_HEADER_SIZE || std::memcmp(map_, MAGIC, 4) != 0) return false;
+
+    uint32_t ver;
+    uint64_t count;
+    std::memcpy(&ver, map_ + 4, 4);
+    std::memcpy(&count, map_ + 8, 8);
+    if (ver != VERSION) return false;
+
+    size_t off = FILE_HEADER_SIZE;
+    for (uint64_t i = 0; i < count; i++) {
+        if (off + sizeof(RecordHeader) > map_size_) return false;
+        RecordHeader rh;
+        std::memcpy(&rh, map_ + off, sizeof(rh));
+        if (rh.record_len < sizeof(RecordHeader) || off + rh.record_len > map_size_) return false;
+        // Its contents must fit the record, or read_mapped() runs past it
+        uint64_t contents = uint64_t(rh.path_len) + rh.name_len + uint64_t(rh.file_count) * sizeof(uint64_t);
+        if (sizeof(RecordHeader) + contents > rh.record_len || rh.hash_len > sizeof(rh.hash)) return false;
+
+        Slot slot;
+        slot.stamp = Stamp{rh.mtime, rh.torrent_size};
+        slot.offset = off;
+        std::string path(reinterpret_cast<const char*>(map_ + off + sizeof(RecordHeader)), rh.path_len);
+        entries_[std::move(path)] = std::move(slot);
+        off += rh.record_len;
+    }
+    return true;
+}
+
+TorrentMetadata TorrentIndex::read_mapped(size_t offset, bool with_file_sizes) const {
+    RecordHeader rh;
+    std::memcpy(&rh, map_ + offset, sizeof(rh));
+
+    const uint8_t* p = map_ + offset + sizeof(RecordHeader) + rh.path_len;
+    TorrentMetadata meta;
+    meta.info_hash = InfoHash(rh.hash, rh.hash_len);
+    meta.name.assign(reinterpret_cast<const char*>(p), rh.name_len);
+    meta.total_size = rh.total_size;
+    meta.file_count = rh.file_count;
+    meta.piece_length = rh.piece_length;
+    if (with_file_sizes) {
+        meta.file_sizes.resize(rh.file_count);
+        std::memcpy(meta.file_sizes.data(), p + rh.name_len, rh.file_count * sizeof(uint64_t));
+    }
+    return meta;
+}
+
+std::optional<TorrentIndex::Stamp> TorrentIndex::stat_file(const std::string& path) {
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (ec) return std::nullopt;
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec) return std::nullopt;
+    return Stamp{static_cast<int64_t>(mtime.time_since_epoch().count()), static_cast<uint64_t>(size)};
+}
+
+std::optional<TorrentMetadata> TorrentIndex::find(const std::string& torrent_path,
+                                                  bool with_file_sizes) const {
+    auto it = entries_.find(torrent_path);
+    if (it == entries_.end()) return std::nullopt;
+
+    auto stamp = stat_file(torrent_path);
+    if (!stamp || stamp->mtime != it->second.stamp.mtime || stamp->size != it->second.stamp.size) {
+        return std::nullopt;
+    }
+
+    const Slot& slot = it->second;
+    if (slot.owned) {
+        TorrentMetadata meta = *slot.owned;
+        if (!with_file_sizes) meta.file_sizes.clear();
+        return meta;
+    }
+    return read_mapped(slot.offset, with_file_sizes);
+}
+
+void TorrentIndex::put(const std::string& torrent_path, TorrentMetadata meta) {
+    // Too long for a record's path_len; such a torrent is parsed every time
+    if (torrent_path.size() > UINT16_MAX) return;
+    auto stamp = stat_file(torrent_path);
+    if (!stamp) return;
+    meta.file_count = static_cast<uint32_t>(meta.file_sizes.size());
+
+    Slot slot;
+    slot.stamp = *stamp;
+    slot.owned = std::move(meta);
+    entries_[torrent_path] = std::move(slot);
+    dirty_ = true;
+}
+
+void TorrentIndex::remove(const std::string& torrent_path) {
+    if (entries_.erase(torrent_path) > 0) dirty_ = true;
+}
+
+void TorrentIndex::retain_only(const std::vector<std::string>& keep) {
+    std::unordered_set<std::string> keep_set(keep.begin(), keep.end());
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (keep_set.count(it->first) == 0) {
+            it = entries_.erase(it);
+            dirty_ = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool TorrentIndex::save() {
+    if (!dirty_ || path_.empty()) return true;
+
+    std::string buf;
+    buf.append(MAGIC, 4);
+    uint32_t ver = VERSION;
+    uint64_t count = entries_.size();
+    buf.append(reinterpret_cast<const char*>(&ver), 4);
+    buf.append(reinterpret_cast<const char*>(&count), 8);
+
+    for (const auto& [path, slot] : entries_) {
+        if (slot.owned) {
+            append_record(buf, path, slot.stamp.mtime, slot.stamp.size, *slot.owned);
+        } else {
+            // Unchanged entry: copy the mapped record verbatim
+            RecordHeader rh;
+            std::memcpy(&rh, map_ + slot.offset, sizeof(rh));
+            buf.append(reinterpret_cast<const char*>(map_ + slot.offset), rh.record_len);
+        }
+    }
+
+    std::string tmp = path_ + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f.is_open()) return false;
+        f.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!f) return false;
+    }
+
+    // Keep the current mapping until the new file is in place: a failed
+    // rename leaves the index as it was, still dirty
+    std::error_code ec;
+    fs::rename(tmp, path_, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    std::string path = path_;
+    close();
+    return open(path);
+}
+
+} // namespace levin
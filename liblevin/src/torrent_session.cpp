@@ -1,5 +1,14 @@
 #include "torrent_session.h"
+#include "disk_manager.h"
+#include "eviction_index.h"
 #include "levin_log.h"
+#include "mpmc_queue.h"
+#include "torrent_index.h"
+#include "info_hash_map.h"
+#include "file_selection.h"
+#include "seed_scheduler.h"
+#include "io_profile.h"
+#include "memory_budget.h"
 
 #ifndef LEVIN_USE_STUB_SESSION
 
@@ -18,13 +27,21 @@
 #include <libtorrent/torrent_status.hpp>
 #include <libtorrent/session_stats.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
 #include <fstream>
-#include <sstream>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <algorithm>
 #include <numeric>
 #include <random>
 #include <filesystem>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace lt = libtorrent;
 namespace fs = std::filesystem;
@@ -38,6 +55,105 @@ static const std::vector<std::string> WSS_TRACKERS = {
     "wss://tracker.btorrent.xyz"
 };
 
+// Parses .torrent files on a pool of worker threads. Anna's Archive torrents
+// list tens of thousands of files, so bdecoding them is CPU-bound; finished
+// add_torrent_params go back to the tick thread through a lock-free queue and
+// try_pop() never blocks.
+class TorrentParsePool {
+public:
+    using ParseFn = std::function<lt::add_torrent_params(const std::string&)>;
+
+    struct Result {
+        std::string path;
+        lt::add_torrent_params params;
+        bool ok = false;
+    };
+
+    TorrentParsePool(ParseFn parse, unsigned num_threads)
+        : parse_(std::move(parse))
+        , results_(RESULT_CAPACITY)
+    {
+        for (unsigned i = 0; i < num_threads; i++) {
+            threads_.emplace_back([this] { worker(); });
+        }
+    }
+
+    ~TorrentParsePool() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    TorrentParsePool(const TorrentParsePool&) = delete;
+    TorrentParsePool& operator=(const TorrentParsePool&) = delete;
+
+    void submit(const std::string& path) {
+        pending_++;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            jobs_.push_back(path);
+        }
+        cv_.notify_one();
+    }
+
+    bool try_pop(Result& out) {
+        if (!results_.try_pop(out)) return false;
+        pending_--;
+        return true;
+    }
+
+    // Submitted but not yet popped
+    int pending() const { return pending_.load(); }
+
+private:
+    static constexpr size_t RESULT_CAPACITY = 256;
+
+    void worker() {
+        for (;;) {
+            std::string path;
+            {
+                std::unique_lock<std::mutex> lock(mu_);
+                cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+                if (stopping_) return;
+                path = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+
+            Result r;
+            r.path = path;
+            try {
+                r.params = parse_(path);
+                r.ok = r.params.ti != nullptr;
+            } catch (const std::exception&) {
+                r.ok = false;
+            }
+
+            // Results queue full: the tick thread is behind, wait for it
+            while (!results_.try_push(std::move(r))) {
+                if (stopping_flag()) return;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+    }
+
+    bool stopping_flag() {
+        std::lock_guard<std::mutex> lock(mu_);
+        return stopping_;
+    }
+
+    ParseFn parse_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::string> jobs_;
+    bool stopping_ = false;
+    MpmcQueue<Result> results_;
+    std::atomic<int> pending_{0};
+    std::vector<std::thread> threads_;
+};
+
 class RealTorrentSession : public ITorrentSession {
 public:
     RealTorrentSession() = default;
@@ -52,6 +168,10 @@ public:
         if (running_) return;
 
         data_dir_ = data_directory;
+        punch_holes_ = can_punch_holes(data_dir_);
+
+        // First seeding rotation soon after start, not a full interval later
+        last_seed_rotation_ = std::chrono::steady_clock::now() - SEED_ROTATION_INTERVAL + SEED_FIRST_ROTATION;
 
         lt::settings_pack sp;
         sp.set_str(lt::settings_pack::listen_interfaces,
@@ -60,13 +180,26 @@ public:
         sp.set_bool(lt::settings_pack::enable_lsd, false);
         sp.set_bool(lt::settings_pack::enable_upnp, true);
         sp.set_bool(lt::settings_pack::enable_natpmp, true);
-        sp.set_int(lt::settings_pack::connections_limit, 200);
+        // Queueing: libtorrent keeps at most this many torrents started, so
+        // connections and announces go to fewer swarms at full strength.
+        // schedule_seeds() decides which seeds get the seeding slots.
+        sp.set_int(lt::settings_pack::active_downloads, ACTIVE_DOWNLOADS);
+        sp.set_int(lt::settings_pack::active_seeds, SEED_SLOTS);
+        sp.set_int(lt::settings_pack::active_limit, ACTIVE_DOWNLOADS + SEED_SLOTS);
+        sp.set_bool(lt::settings_pack::dont_count_slow_torrents, true);
+
+        apply_io_profile(sp);
+        memory_settings_ = derive_memory_settings(memory_budget_, 0, ACTIVE_DOWNLOADS + SEED_SLOTS, io_settings_);
+        memory_torrents_ = 0;
+        apply_memory_settings(sp);
 
         // Alert mask
         sp.set_int(lt::settings_pack::alert_mask,
                    lt::alert_category::error
                    | lt::alert_category::status
-                   | lt::alert_category::storage);
+                   | lt::alert_category::storage
+                   | lt::alert_category::piece_progress   // disk usage accounting
+                   | lt::alert_category::file_progress);
 
         // WebTorrent/WebRTC via libdatachannel (requires master branch + webtorrent=ON)
 #ifdef TORRENT_USE_RTC
@@ -87,6 +220,7 @@ public:
                     session_ = std::make_unique<lt::session>(std::move(params));
                     running_ = true;
                     paused_ = false;
+                    start_parse_pool();
                     return;
                 }
             } catch (const std::exception&) {
@@ -97,70 +231,112 @@ public:
         session_ = std::make_unique<lt::session>(sp);
         running_ = true;
         paused_ = false;
+        start_parse_pool();
     }
 
     void stop() override {
         if (!running_) return;
+        parse_pool_.reset();
+        save_all_resume_data();
         session_.reset();
         running_ = false;
         paused_ = false;
-        torrents_.clear();
+        soft_paused_ = false;
+        registry_.clear();
+        unloaded_count_ = 0;
+        totals_ = StatusTotals{};
+        metrics_ = SessionMetrics{};
+        disk_delta_ = DiskUsageDelta{};
+        release_results_ = std::make_shared<ReleaseResults>();  // jobs still running report to the old one
+        wasted_bytes_ = 0;
+        resume_outstanding_ = 0;
     }
 
     bool is_running() const override { return running_; }
 
-    std::optional<std::string> add_torrent(const std::string& torrent_path) override {
-        if (!running_ || !session_) return std::nullopt;
+    void process_alerts() override {
+        if (!session_) return;
 
-        try {
-            lt::add_torrent_params atp = lt::load_torrent_file(torrent_path);
-            atp.save_path = data_dir_;
+        // Request a state_update_alert for every torrent whose status changed
+        // since the previous request. It is delivered with a later pop_alerts(),
+        // so the cache lags by at most one tick.
+        session_->post_torrent_updates({});
+        session_->post_session_stats();
 
-            // Inject WebSocket trackers at tier 0
-            for (const auto& tracker : WSS_TRACKERS) {
-                atp.trackers.push_back(tracker);
-                atp.tracker_tiers.push_back(0);
-            }
+        dispatch_alerts();
+        finish_releases();
+        add_parsed_torrents();
+        rebalance_memory();
+
+        // Periodic resume checkpoint, so a crash loses at most one interval
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_resume_checkpoint_ >= RESUME_CHECKPOINT_INTERVAL) {
+            last_resume_checkpoint_ = now;
+            checkpoint_resume_data();
+        }
+
+        // Paused, the seeds upload nothing; that says nothing about demand
+        if (now - last_seed_sample_ >= SEED_SAMPLE_INTERVAL && !paused_ && !soft_paused_) {
+            last_seed_sample_ = now;
+            sample_seed_demand(now);
+        }
+        if (now - last_seed_rotation_ >= SEED_ROTATION_INTERVAL) {
+            last_seed_rotation_ = now;
+            schedule_seeds(now);
+        }
+    }
 
+    std::optional<InfoHash> add_torrent(const std::string& torrent_path) override {
+        if (!running_ || !session_) return std::nullopt;
+
+        try {
+            lt::add_torrent_params atp = prepare_add_params(torrent_path);
+            if (downloads_paused_) atp.flags |= lt::torrent_flags::upload_mode;
             lt::torrent_handle h = session_->add_torrent(atp);
-            std::string hash = to_hex(h.info_hash());
-            torrents_[hash] = h;
+            InfoHash hash = key_of(h.info_hashes());
+            register_torrent(hash, h, torrent_path, *atp.ti);
             return hash;
         } catch (const std::exception&) {
             return std::nullopt;
         }
     }
 
-    void remove_torrent(const std::string& info_hash) override {
-        auto it = torrents_.find(info_hash);
-        if (it != torrents_.end() && session_) {
-            session_->remove_torrent(it->second);
-            torrents_.erase(it);
+    bool async_add_torrent(const std::string& torrent_path) override {
+        if (!running_ || !parse_pool_) return false;
+        parse_pool_->submit(torrent_path);
+        return true;
+    }
+
+    int pending_adds() const override {
+        return parse_pool_ ? parse_pool_->pending() : 0;
+    }
+
+    bool is_known_seed(const std::string& torrent_path) const override {
+        return known_seeds_.count(torrent_path) > 0;
+    }
+
+    void remove_torrent(const InfoHash& info_hash) override {
+        auto it = registry_.find(info_hash);
+        if (it != registry_.end() && session_ && it->second.handle.is_valid()) {
+            session_->remove_torrent(it->second.handle);
         }
+        if (!resume_dir_.empty()) {
+            std::error_code ec;
+            fs::remove(resume_path(info_hash), ec);
+        }
+        forget_torrent(info_hash);
     }
 
     int torrent_count() const override {
-        return static_cast<int>(torrents_.size());
+        return static_cast<int>(registry_.size());
     }
 
     std::vector<TorrentInfo> get_torrent_list() const override {
         std::vector<TorrentInfo> result;
         if (!session_) return result;
-        for (const auto& [hash, handle] : torrents_) {
-            if (!handle.is_valid()) continue;
-            auto st = handle.status(lt::torrent_handle::query_name);
-            TorrentInfo ti;
-            ti.info_hash = hash;
-            ti.name = st.name;
-            ti.size = st.total_wanted;
-            ti.downloaded = st.total_done;
-            ti.uploaded = st.total_upload;
-            ti.download_rate = st.download_rate;
-            ti.upload_rate = st.upload_rate;
-            ti.num_peers = st.num_peers;
-            ti.progress = static_cast<double>(st.progress);
-            ti.is_seed = st.is_seeding;
-            result.push_back(std::move(ti));
+        result.reserve(registry_.size());
+        for (const auto& [hash, e] : registry_) {
+            result.push_back(e.status.info);
         }
         return result;
     }
@@ -174,6 +350,7 @@ public:
 
     void resume_session() override {
         if (session_) {
+            end_soft_pause();
             session_->resume();
             paused_ = false;
         }
@@ -181,14 +358,51 @@ public:
 
     bool is_paused() const override { return paused_; }
 
+    // Every peer is choked and no pieces are requested, but connections,
+    // announces and the DHT stay up, so resume_session() picks up at once.
+    // libtorrent keeps one optimistic unchoke slot at any slot limit; the
+    // 1 B/s upload cap covers that peer.
+    void soft_pause_session() override {
+        if (!session_ || paused_ || soft_paused_) return;
+        soft_paused_ = true;
+        saved_unchoke_slots_ = session_->get_settings().get_int(lt::settings_pack::unchoke_slots_limit);
+        lt::settings_pack sp;
+        sp.set_int(lt::settings_pack::unchoke_slots_limit, 0);
+        sp.set_int(lt::settings_pack::upload_rate_limit, 1);
+        session_->apply_settings(std::move(sp));
+
+        // Already seed-only (SEEDING): resume_session() must leave it so
+        soft_paused_downloads_ = !downloads_paused_;
+        if (soft_paused_downloads_) pause_downloads();
+        LEVIN_LOG("soft pause: peers choked, downloads stopped");
+    }
+
+    bool is_soft_paused() const override { return soft_paused_ && !paused_; }
+
+    // Seed-only: every torrent goes into upload mode, so no piece requests
+    // go out and peers aren't told we're interested. File priorities are
+    // left alone, so resuming restores exactly what the budget had planned.
     void pause_downloads() override {
-        set_download_rate_limit(1);
+        downloads_paused_ = true;
+        int entered = 0;
+        for (auto& [hash, e] : registry_) {
+            if (enter_seed_only(e)) entered++;
+        }
+        LEVIN_LOG("pause_downloads: %d torrents in upload mode", entered);
     }
 
     void resume_downloads() override {
-        set_download_rate_limit(0);
+        downloads_paused_ = false;
+        for (auto& [hash, e] : registry_) {
+            if (!e.seed_only) continue;
+            if (e.handle.is_valid()) e.handle.unset_flags(lt::torrent_flags::upload_mode);
+            e.seed_only = false;
+            e.status.upload_mode = false;
+        }
     }
 
+    bool downloads_paused() const override { return downloads_paused_; }
+
     void set_download_rate_limit(int bytes_per_sec) override {
         if (!session_) return;
         lt::settings_pack sp;
@@ -199,6 +413,8 @@ public:
 
     void set_upload_rate_limit(int bytes_per_sec) override {
         if (!session_) return;
+        upload_rate_limit_ = bytes_per_sec;
+        if (soft_paused_) return;  // applied by end_soft_pause()
         lt::settings_pack sp;
         sp.set_int(lt::settings_pack::upload_rate_limit, bytes_per_sec);
         session_->apply_settings(sp);
@@ -209,58 +425,31 @@ public:
     }
 
     int peer_count() const override {
-        if (!session_) return 0;
-        int total = 0;
-        for (const auto& [hash, handle] : torrents_) {
-            if (!handle.is_valid()) continue;
-            auto st = handle.status(lt::torrent_handle::query_name);
-            total += st.num_peers;
-        }
-        return total;
+        return session_ ? totals_.num_peers : 0;
     }
 
     int download_rate() const override {
-        if (!session_) return 0;
-        int total = 0;
-        for (const auto& [hash, handle] : torrents_) {
-            if (!handle.is_valid()) continue;
-            auto st = handle.status();
-            total += st.download_rate;
-        }
-        return total;
+        return session_ ? totals_.download_rate : 0;
     }
 
     int upload_rate() const override {
-        if (!session_) return 0;
-        int total = 0;
-        for (const auto& [hash, handle] : torrents_) {
-            if (!handle.is_valid()) continue;
-            auto st = handle.status();
-            total += st.upload_rate;
-        }
-        return total;
+        return session_ ? totals_.upload_rate : 0;
     }
 
     uint64_t total_downloaded() const override {
-        if (!session_) return 0;
-        uint64_t total = 0;
-        for (const auto& [hash, handle] : torrents_) {
-            if (!handle.is_valid()) continue;
-            auto st = handle.status();
-            total += st.total_download;
-        }
-        return total;
+        return session_ ? metrics_.payload_recv_bytes : 0;
     }
 
     uint64_t total_uploaded() const override {
-        if (!session_) return 0;
-        uint64_t total = 0;
-        for (const auto& [hash, handle] : torrents_) {
-            if (!handle.is_valid()) continue;
-            auto st = handle.status();
-            total += st.total_upload;
-        }
-        return total;
+        return session_ ? metrics_.payload_sent_bytes : 0;
+    }
+
+    uint64_t wasted_bytes() const override {
+        return wasted_bytes_;
+    }
+
+    SessionMetrics session_metrics() const override {
+        return session_ ? metrics_ : SessionMetrics{};
     }
 
     bool is_webtorrent_enabled() const override {
@@ -271,12 +460,12 @@ public:
 #endif
     }
 
-    std::vector<std::string> get_trackers(const std::string& info_hash) const override {
-        auto it = torrents_.find(info_hash);
-        if (it == torrents_.end()) return {};
+    std::vector<std::string> get_trackers(const InfoHash& info_hash) const override {
+        auto it = registry_.find(info_hash);
+        if (it == registry_.end() || !it->second.handle.is_valid()) return {};
 
         std::vector<std::string> result;
-        auto trackers = it->second.trackers();
+        auto trackers = it->second.handle.trackers();
         for (const auto& t : trackers) {
             result.push_back(t.url);
         }
@@ -290,56 +479,122 @@ public:
         int total_enabled = 0;
         int total_disabled = 0;
         int total_complete = 0;
+        int torrents_skipped = 0;
+        int files_changed = 0;
+        bool rarest = (file_selection_ == FileSelection::RAREST_FIRST);
+        auto now = std::chrono::steady_clock::now();
 
-        for (auto& [hash, handle] : torrents_) {
-            if (!handle.is_valid()) continue;
+        for (const InfoHash& hash : budget_order()) {
+            TorrentEntry& e = registry_.find(hash)->second;
+            lt::torrent_handle& handle = e.handle;
+            if (!handle.is_valid() || e.residency != Residency::LOADED) continue;
+            uint64_t total_done = e.status.info.downloaded;
+            if (!e.evicted.empty() && expire_evictions(e, now)) e.plan.valid = false;
 
-            auto ti = handle.torrent_file();
-            if (!ti) continue;
+            // Nothing moved since the last pass: the previous plan still holds.
+            // Swarm availability drifts on its own, so rarest-first plans expire.
+            BudgetPlan& plan = e.plan;
+            bool expired = rarest && now - plan.planned_at >= AVAILABILITY_REFRESH;
+            if (plan.valid && !expired && plan.budget_in == remaining && plan.total_done == total_done) {
+                remaining -= plan.consumed;
+                total_enabled += plan.enabled;
+                total_disabled += plan.disabled;
+                total_complete += plan.complete;
+                torrents_skipped++;
+                continue;
+            }
 
-            const auto& fs = ti->layout();
-            int num_files = fs.num_files();
+            if (plan.file_sizes.empty() && !load_file_layout(hash, e)) continue;
+            int num_files = static_cast<int>(plan.file_sizes.size());
             if (num_files == 0) continue;
 
+            if (static_cast<int>(plan.order.size()) != num_files) {
+                // Build shuffled index list so we don't always prioritize the same files.
+                // Use a deterministic seed per torrent so priorities don't flip-flop each tick
+                plan.order.resize(num_files);
+                std::iota(plan.order.begin(), plan.order.end(), 0);
+                std::seed_seq seed{hash.hash_code()};
+                std::mt19937 rng(seed);
+                std::shuffle(plan.order.begin(), plan.order.end(), rng);
+            }
+            if (static_cast<int>(plan.applied.size()) != num_files) {
+                plan.applied = handle.get_file_priorities();
+                plan.applied.resize(num_files, lt::default_priority);
+            }
+
             // Get per-file progress (bytes downloaded per file)
             std::vector<std::int64_t> progress;
             handle.file_progress(progress, lt::torrent_handle::piece_granularity);
 
-            // Build shuffled index list so we don't always prioritize the same files
-            std::vector<int> indices(num_files);
-            std::iota(indices.begin(), indices.end(), 0);
-            // Use a deterministic seed per torrent so priorities don't flip-flop each tick
-            std::seed_seq seed{std::hash<std::string>{}(hash)};
-            std::mt19937 rng(seed);
-            std::shuffle(indices.begin(), indices.end(), rng);
+            // Rarest first: files fewest connected peers can supply get the budget first
+            std::vector<int> ranked;
+            if (rarest && plan.piece_length > 0) {
+                std::vector<int> availability;
+                handle.piece_availability(availability);
+                ranked = rank_rarest_first(
+                    file_availability(plan.file_sizes, plan.piece_length, availability), plan.order);
+            }
+            const std::vector<int>& order = ranked.empty() ? plan.order : ranked;
+
+            std::vector<lt::download_priority_t> wanted = plan.applied;
+            plan.budget_in = remaining;
+            plan.enabled = plan.disabled = plan.complete = 0;
 
-            for (int idx : indices) {
-                std::int64_t file_size = fs.file_size(lt::file_index_t{idx});
+            for (int idx : order) {
+                std::int64_t file_size = plan.file_sizes[idx];
                 std::int64_t downloaded = (idx < static_cast<int>(progress.size())) ? progress[idx] : 0;
                 std::int64_t bytes_left = file_size - downloaded;
 
+                if (e.evicted.count(idx)) {
+                    // Deleted to make room; fetching it again so soon would undo that
+                    wanted[idx] = lt::dont_download;
+                    plan.disabled++;
+                    continue;
+                }
+
                 if (bytes_left <= 0) {
-                    // Already complete — keep default priority for seeding
-                    total_complete++;
+                    // Already complete — keep current priority for seeding
+                    plan.complete++;
                     continue;
                 }
 
                 if (static_cast<uint64_t>(bytes_left) <= remaining) {
                     // Fits in budget — enable download
-                    handle.file_priority(lt::file_index_t{idx}, lt::default_priority);
+                    wanted[idx] = lt::default_priority;
                     remaining -= static_cast<uint64_t>(bytes_left);
-                    total_enabled++;
+                    plan.enabled++;
                 } else {
                     // Doesn't fit — disable download
-                    handle.file_priority(lt::file_index_t{idx}, lt::dont_download);
-                    total_disabled++;
+                    wanted[idx] = lt::dont_download;
+                    plan.disabled++;
                 }
             }
+
+            // Push only actual changes, as one batch per torrent
+            int changed = 0;
+            for (int idx = 0; idx < num_files; idx++) {
+                if (wanted[idx] != plan.applied[idx]) changed++;
+            }
+            if (changed > 0) {
+                handle.prioritize_files(wanted);
+                plan.applied = std::move(wanted);
+                files_changed += changed;
+                // Newly wanted files need the torrent back in the download queue
+                if (plan.enabled > 0) unpark_seed(e);
+            }
+
+            plan.consumed = plan.budget_in - remaining;
+            plan.total_done = total_done;
+            plan.planned_at = now;
+            plan.valid = true;
+            total_enabled += plan.enabled;
+            total_disabled += plan.disabled;
+            total_complete += plan.complete;
         }
 
-        LEVIN_LOG("apply_budget_priorities: budget=%llu remaining=%llu enabled=%d disabled=%d complete=%d",
+        LEVIN_LOG("apply_budget_priorities: budget=%llu remaining=%llu enabled=%d disabled=%d complete=%d skipped=%d changed=%d",
                   (unsigned long long)budget_bytes, (unsigned long long)remaining,
-                  total_enabled, total_disabled, total_complete);
+                  total_enabled, total_disabled, total_complete, torrents_skipped, files_changed);
     }
 
     void save_state(const std::string& path) override {
@@ -358,22 +613,1273 @@ public:
         pending_state_path_ = path;
     }
 
+    void set_resume_directory(const std::string& dir) override {
+        resume_dir_ = dir;
+        if (!resume_dir_.empty()) {
+            std::error_code ec;
+            fs::create_directories(resume_dir_, ec);
+            load_known_seeds();
+        }
+    }
+
+    void set_metadata_index(TorrentIndex* index) override {
+        index_ = index;
+    }
+
+    void set_eviction_index(EvictionIndex* index) override {
+        eviction_ = index;
+    }
+
+    void set_eviction_cooldown(int secs) override {
+        eviction_cooldown_ = std::chrono::seconds(std::max(secs, 0));
+    }
+
+    void set_disk_job_runner(DiskJobRunner runner) override {
+        disk_job_runner_ = std::move(runner);
+    }
+
+    void set_unload_inactive(bool enabled) override {
+        unload_inactive_ = enabled;
+    }
+
+    bool add_unloaded_torrent(const std::string& torrent_path) override {
+        if (!running_ || !unload_inactive_ || !index_ || resume_dir_.empty()) return false;
+        auto meta = index_->find(torrent_path);
+        if (!meta || meta->info_hash.empty()) return false;
+        const InfoHash& hash = meta->info_hash;
+        if (registry_.count(hash)) return true;
+        if (!fs::exists(resume_path(hash))) return false;
+
+        TorrentEntry& e = registry_[hash];
+        e.path = torrent_path;
+        e.residency = Residency::UNLOADED;
+        unloaded_count_++;
+        CachedStatus& cs = e.status;
+        cs.info.info_hash = hash;
+        cs.info.name = meta->name;
+        cs.info.size = meta->total_size;
+        cs.info.downloaded = meta->total_size;
+        cs.info.progress = 1.0;
+        cs.info.is_seed = true;
+        cs.finished = true;
+        e.activity.parked = true;
+        return true;
+    }
+
+    void set_io_profile(IoProfile profile) override {
+        io_profile_ = profile;
+    }
+
+    void set_memory_budget(uint64_t bytes) override {
+        memory_budget_ = bytes;
+    }
+
+    uint64_t memory_estimate() const override {
+        return estimate_memory_usage(loaded_count(), metrics_.peers_connected,
+                                     metrics_.disk_queued_bytes, memory_settings_);
+    }
+
+    DiskUsageDelta take_disk_usage_delta() override {
+        DiskUsageDelta d = disk_delta_;
+        disk_delta_ = DiskUsageDelta{};
+        std::lock_guard<std::mutex> lock(release_results_->mutex);
+        if (release_results_->failed) d.rescan = true;
+        release_results_->failed = false;
+        return d;
+    }
+
+    void set_file_selection(FileSelection mode) override {
+        if (mode == file_selection_) return;
+        file_selection_ = mode;
+        for (auto& [hash, e] : registry_) e.plan.valid = false;
+    }
+
+    std::vector<std::string> evict_files(const std::vector<std::string>& paths) override {
+        if (!session_) return paths;
+
+        OwnerLookup lookup = make_owner_lookup();
+        std::vector<std::string> unowned;
+        std::vector<std::pair<InfoHash, std::vector<int>>> owners;  // and the files taken from each
+        auto until = std::chrono::steady_clock::now() + eviction_cooldown_;
+        for (const std::string& path : paths) {
+            auto owner = find_owner(lookup, path);
+            if (!owner) {
+                unowned.push_back(path);
+                continue;
+            }
+            auto [hash, idx] = *owner;
+            TorrentEntry& e = registry_.find(hash)->second;
+            e.evicted[idx] = until;
+            if (std::find(e.evicting.begin(), e.evicting.end(), idx) != e.evicting.end()) continue;
+            e.evicting.push_back(idx);
+            if (e.readd) forget_file(*e.readd, idx);
+            if (owners.empty() || owners.back().first != hash) owners.emplace_back(hash, std::vector<int>{});
+            owners.back().second.push_back(idx);
+        }
+
+        for (const auto& [hash, taken] : owners) {
+            TorrentEntry& e = registry_.find(hash)->second;
+            count_wasted(e, taken);
+            if (e.residency == Residency::LOADED) begin_eviction(e);
+        }
+        return unowned;
+    }
+
+    uint64_t shrink_file(const std::string& path, uint64_t bytes) override {
+        if (!session_ || !punch_holes_) return 0;  // the file goes whole instead
+
+        OwnerLookup lookup = make_owner_lookup();
+        auto owner = find_owner(lookup, path);
+        if (!owner) return 0;
+        auto [hash, idx] = *owner;
+        TorrentEntry& e = registry_.find(hash)->second;
+        if (std::find(e.evicting.begin(), e.evicting.end(), idx) != e.evicting.end()) return 0;
+        if (e.readd || !e.handle.is_valid()) return 0;  // already out of the session
+        auto ti = e.handle.torrent_file();
+        if (!ti) return 0;
+
+        // Pieces that lie wholly inside the file, from its end backwards,
+        // that the torrent has: a hole there frees a whole piece and leaves
+        // neighbouring files alone. Pieces punched before are no longer had.
+        const lt::file_storage& files = ti->files();
+        int64_t plen = ti->piece_length();
+        int64_t begin = files.file_offset(lt::file_index_t(idx));
+        int64_t end = begin + files.file_size(lt::file_index_t(idx));
+        int64_t total = files.total_size();
+        int first = static_cast<int>((begin + plen - 1) / plen);
+        int last = static_cast<int>(end / plen) - 1;
+        if (end == total) last = ti->num_pieces() - 1;  // the short last piece ends the torrent
+        lt::torrent_status st = e.handle.status(lt::torrent_handle::query_pieces);
+
+        uint64_t freed = 0;
+        std::vector<PieceRange> ranges;
+        for (int p = last; p >= first && freed < bytes; p--) {
+            if (p >= st.pieces.size() || !st.pieces.get_bit(lt::piece_index_t(p))) continue;
+            if (!ranges.empty() && ranges.back().first == p + 1) {
+                ranges.back().first = p;
+            } else {
+                ranges.push_back({idx, p, p});
+            }
+            freed += static_cast<uint64_t>(std::min<int64_t>(plen, total - p * plen));
+        }
+        if (ranges.empty()) return 0;
+
+        if (e.status.all_time_upload == 0) wasted_bytes_ += freed;
+        e.evicted[idx] = std::chrono::steady_clock::now() + eviction_cooldown_;
+        for (const PieceRange& r : ranges) {
+            e.punching.push_back(r);
+            if (e.readd) forget_pieces(*e.readd, r);
+        }
+        if (e.residency == Residency::LOADED) begin_eviction(e);
+        return freed;
+    }
+
 private:
-    static std::string to_hex(const lt::sha1_hash& hash) {
-        std::ostringstream oss;
-        oss << hash;
-        return oss.str();
+    // Last known status of a torrent, as reported by state_update_alert
+    struct CachedStatus {
+        TorrentInfo info{};
+        bool finished = false;  // every wanted piece downloaded
+        int swarm_seeds = 0;    // see swarm_seed_count()
+        int swarm_leechers = 0;
+        bool upload_mode = false;  // requesting no pieces, whoever set it
+        uint64_t all_time_upload = 0;  // across sessions, kept in resume data
+    };
+
+    // Last budget allocation applied to a torrent. apply_budget_priorities()
+    // skips torrents whose incoming budget and progress are unchanged, and
+    // otherwise pushes only the priorities that differ from `applied`.
+    struct BudgetPlan {
+        std::vector<int> order;                        // shuffled file indices, fixed per torrent
+        std::vector<lt::download_priority_t> applied;  // priorities last pushed to libtorrent
+        std::vector<std::int64_t> file_sizes;          // per-file sizes, loaded once
+        int piece_length = 0;
+        std::chrono::steady_clock::time_point planned_at;
+        uint64_t budget_in = 0;   // budget remaining when this torrent was planned
+        uint64_t consumed = 0;    // part of budget_in claimed by this torrent's files
+        uint64_t total_done = 0;  // torrent progress at planning time
+        int enabled = 0;
+        int disabled = 0;
+        int complete = 0;
+        bool valid = false;
+    };
+
+    struct SeedActivity {
+        double upload_ewma = 0;
+        std::chrono::steady_clock::time_point last_active;
+        bool seen_active = false;  // sampled at least once while holding a slot
+        bool parked = false;       // paused and taken out of the queue by schedule_seeds()
+    };
+
+    enum class Residency {
+        LOADED,     // in the session (handle invalid while the add is in flight)
+        UNLOADING,  // waiting for resume data before removal
+        EVICTING,   // being removed so evicted files can go, then added back
+        UNLOADED,   // registered, but not in the session
+    };
+
+    // Pieces [first, last] of a torrent, all inside file `file`
+    struct PieceRange {
+        int file;
+        int first;
+        int last;
+    };
+
+    // Everything kept per torrent, in one registry slot
+    struct TorrentEntry {
+        lt::torrent_handle handle;
+        std::string path;  // .torrent file
+        CachedStatus status;
+        BudgetPlan plan;
+        SeedActivity activity;
+        Residency residency = Residency::LOADED;
+        bool seed_only = false;  // in upload mode because of pause_downloads()
+        int piece_length = 0;    // for sizing finished pieces
+        int64_t total_size = 0;  // all files, wanted or not; status.info.size is only the wanted
+        std::vector<int> evicting;       // files to unlink once the torrent is out of the session
+        std::vector<PieceRange> punching;  // pieces to punch out of files, likewise
+        // Files taken by evict_files() or shrink_file(), not funded again until then
+        std::unordered_map<int, std::chrono::steady_clock::time_point> evicted;
+        std::optional<lt::add_torrent_params> readd;  // edited resume data, once removal is requested
+        int resume_pending = 0;  // save_resume_data requests not answered yet
+        int eviction_skip = 0;   // replies due before the eviction's own (see take_resume_reply)
+        bool releasing = false;  // a release job for its files hasn't finished
+    };
+
+    int loaded_count() const {
+        return static_cast<int>(registry_.size() - unloaded_count_);
+    }
+
+    // Running sums over the registry's statuses, so the stats getters are O(1)
+    struct StatusTotals {
+        int num_peers = 0;
+        int download_rate = 0;
+        int upload_rate = 0;
+
+        void add(const CachedStatus& cs) {
+            num_peers += cs.info.num_peers;
+            download_rate += cs.info.download_rate;
+            upload_rate += cs.info.upload_rate;
+        }
+
+        void remove(const CachedStatus& cs) {
+            num_peers -= cs.info.num_peers;
+            download_rate -= cs.info.download_rate;
+            upload_rate -= cs.info.upload_rate;
+        }
+    };
+
+    void dispatch_alerts() {
+        std::vector<lt::alert*> alerts;
+        session_->pop_alerts(&alerts);
+        for (lt::alert* a : alerts) {
+            if (auto* su = lt::alert_cast<lt::state_update_alert>(a)) {
+                for (const auto& st : su->status) {
+                    update_cached_status(st);
+                }
+            } else if (auto* ss = lt::alert_cast<lt::session_stats_alert>(a)) {
+                update_metrics(ss->counters());
+            } else if (auto* rd = lt::alert_cast<lt::save_resume_data_alert>(a)) {
+                if (resume_outstanding_ > 0) resume_outstanding_--;
+                InfoHash hash = key_of(rd->params.info_hashes);
+                ResumeReply reply = take_resume_reply(hash);
+                if (reply == ResumeReply::EVICTION) {
+                    take_eviction_resume(hash, rd->params);
+                } else if (reply == ResumeReply::ORDINARY) {
+                    write_resume_data(rd->params);
+                    note_seed_state(hash);
+                    finish_unload(hash);
+                }
+            } else if (auto* rf = lt::alert_cast<lt::save_resume_data_failed_alert>(a)) {
+                // Includes "not modified" replies to only_if_modified requests
+                if (resume_outstanding_ > 0) resume_outstanding_--;
+                // Unload anyway; without resume data the re-add rechecks the files
+                if (rf->handle.is_valid()) {
+                    InfoHash hash = key_of(rf->handle.info_hashes());
+                    ResumeReply reply = take_resume_reply(hash);
+                    if (reply == ResumeReply::EVICTION) {
+                        evict_in_place(hash);
+                    } else if (reply == ResumeReply::ORDINARY) {
+                        finish_unload(hash);
+                    }
+                }
+            } else if (auto* tr = lt::alert_cast<lt::torrent_removed_alert>(a)) {
+                finish_eviction(key_of(tr->info_hashes));
+            } else if (auto* tf = lt::alert_cast<lt::torrent_finished_alert>(a)) {
+                // Persist completion right away so a restart seeds without re-checking
+                auto it = registry_.find(key_of(tf->handle.info_hashes()));
+                if (it != registry_.end()) {
+                    it->second.status.finished = true;
+                    // Somebody wanted this enough to download it
+                    if (eviction_) eviction_->add_demand(it->second.status.info.name, 1, unix_now());
+                }
+                request_resume_data(tf->handle, lt::torrent_handle::flush_disk_cache);
+            } else if (auto* at = lt::alert_cast<lt::add_torrent_alert>(a)) {
+                on_torrent_added(*at);
+            } else if (auto* pf = lt::alert_cast<lt::piece_finished_alert>(a)) {
+                disk_delta_.bytes += piece_size(key_of(pf->handle.info_hashes()),
+                                                static_cast<int>(pf->piece_index));
+            } else if (lt::alert_cast<lt::file_completed_alert>(a)) {
+                disk_delta_.files++;
+            } else if (lt::alert_cast<lt::file_error_alert>(a) ||
+                       lt::alert_cast<lt::storage_moved_alert>(a) ||
+                       lt::alert_cast<lt::file_renamed_alert>(a) ||
+                       lt::alert_cast<lt::torrent_deleted_alert>(a)) {
+                // Files may have changed in ways piece counts don't show
+                disk_delta_.rescan = true;
+            }
+        }
+
+        if (known_seeds_dirty_) {
+            save_known_seeds();
+            known_seeds_dirty_ = false;
+        }
+    }
+
+    // Disk subsystem settings for the storage class holding data_dir_
+    void apply_io_profile(lt::settings_pack& sp) {
+        IoProfile profile = (io_profile_ == IoProfile::AUTO) ? detect_io_profile(data_dir_) : io_profile_;
+        DiskIoSettings io = io_settings_for(profile);
+        io_settings_ = io;
+        int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+        sp.set_int(lt::settings_pack::aio_threads, io.aio_threads);
+        sp.set_int(lt::settings_pack::hashing_threads, std::min(io.hashing_threads, cores));
+        sp.set_int(lt::settings_pack::disk_io_write_mode,
+                   io.write_mode == DiskWriteMode::WRITE_THROUGH
+                       ? lt::settings_pack::write_through
+                       : lt::settings_pack::enable_os_cache);
+        sp.set_int(lt::settings_pack::send_buffer_watermark_factor, io.send_buffer_watermark_factor);
+        LEVIN_LOG("disk I/O profile: %s%s", io_profile_name(profile),
+                  io_profile_ == IoProfile::AUTO ? " (detected)" : "");
+        // Disk queue and send buffer sizes come from memory_settings_, which
+        // caps them at the profile's values
+    }
+
+    void apply_memory_settings(lt::settings_pack& sp) const {
+        const MemorySettings& m = memory_settings_;
+        sp.set_int(lt::settings_pack::connections_limit, m.connections_limit);
+        sp.set_int(lt::settings_pack::max_peerlist_size, m.max_peerlist_size);
+        sp.set_int(lt::settings_pack::max_paused_peerlist_size, m.max_paused_peerlist_size);
+        sp.set_int(lt::settings_pack::alert_queue_size, m.alert_queue_size);
+        sp.set_int(lt::settings_pack::max_queued_disk_bytes, m.max_queued_disk_bytes);
+        sp.set_int(lt::settings_pack::send_buffer_low_watermark, m.send_buffer_low_watermark);
+        sp.set_int(lt::settings_pack::send_buffer_watermark, m.send_buffer_watermark);
+    }
+
+    // Per-torrent costs dominate with a large library, so re-derive the
+    // limits once the torrent count has moved by more than a tenth
+    void rebalance_memory() {
+        if (memory_budget_ == 0) return;
+        int n = loaded_count();
+        if (std::abs(n - memory_torrents_) <= std::max(memory_torrents_ / 10, 10)) return;
+
+        memory_torrents_ = n;
+        memory_settings_ = derive_memory_settings(memory_budget_, n, ACTIVE_DOWNLOADS + SEED_SLOTS, io_settings_);
+        lt::settings_pack sp;
+        apply_memory_settings(sp);
+        session_->apply_settings(std::move(sp));
+        LEVIN_LOG("memory budget %llu: torrents=%d connections=%d peerlist=%d/%d",
+                  (unsigned long long)memory_budget_, n, memory_settings_.connections_limit,
+                  memory_settings_.max_peerlist_size, memory_settings_.max_paused_peerlist_size);
+    }
+
+    // --- Torrent bookkeeping ---
+
+    lt::add_torrent_params prepare_add_params(const std::string& torrent_path) const {
+        lt::add_torrent_params atp = lt::load_torrent_file(torrent_path);
+
+        // Fast resume: reuse the piece state saved last time instead of
+        // re-hashing everything on disk
+        if (auto resumed = load_resume_data(key_of(atp.ti->info_hashes()))) {
+            resumed->ti = atp.ti;
+            atp = std::move(*resumed);
+        }
+        atp.save_path = data_dir_;
+
+        // Start in libtorrent's queue; a seed parked by schedule_seeds() last
+        // run gets a fresh turn rather than staying paused for good
+        atp.flags |= lt::torrent_flags::auto_managed;
+        atp.flags &= ~lt::torrent_flags::paused;
+        // Upload mode in resume data is left over from seed-only mode (or an
+        // old disk error); the caller sets it again if downloads are paused
+        atp.flags &= ~lt::torrent_flags::upload_mode;
+
+        // Inject WebSocket trackers at tier 0 (resume data already carries them)
+        for (const auto& tracker : WSS_TRACKERS) {
+            if (std::find(atp.trackers.begin(), atp.trackers.end(), tracker) != atp.trackers.end()) {
+                continue;
+            }
+            atp.trackers.push_back(tracker);
+            atp.tracker_tiers.push_back(0);
+        }
+        return atp;
+    }
+
+    void start_parse_pool() {
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        parse_pool_ = std::make_unique<TorrentParsePool>(
+            [this](const std::string& path) { return prepare_add_params(path); }, threads);
+    }
+
+    // Hand torrents parsed by the pool to libtorrent. Bounded per tick so a
+    // cold start doesn't stall the tick thread on bookkeeping either.
+    void add_parsed_torrents() {
+        if (!parse_pool_) return;
+        TorrentParsePool::Result r;
+        for (int i = 0; i < PARSED_ADDS_PER_TICK && parse_pool_->try_pop(r); i++) {
+            if (!r.ok) {
+                LEVIN_LOG("failed to parse torrent: %s", r.path.c_str());
+                continue;
+            }
+            InfoHash hash = key_of(r.params.ti->info_hashes());
+            auto it = registry_.find(hash);
+            if (it != registry_.end() && it->second.residency != Residency::UNLOADED) {
+                continue;  // already added or in flight
+            }
+
+            // The handle stays invalid until the add_torrent_alert arrives
+            register_torrent(hash, lt::torrent_handle{}, r.path, *r.params.ti);
+            if (downloads_paused_) r.params.flags |= lt::torrent_flags::upload_mode;
+            session_->async_add_torrent(std::move(r.params));
+        }
+    }
+
+    void register_torrent(const InfoHash& hash, const lt::torrent_handle& h,
+                          const std::string& torrent_path, const lt::torrent_info& ti) {
+        // A reloaded torrent keeps its budget plan and seeding history
+        auto [it, inserted] = registry_.try_emplace(hash);
+        TorrentEntry& e = it->second;
+        if (!inserted) {
+            totals_.remove(e.status);
+            if (e.residency == Residency::UNLOADED) unloaded_count_--;
+        }
+        e.handle = h;
+        e.path = torrent_path;
+        e.residency = Residency::LOADED;
+        e.seed_only = downloads_paused_;  // added in upload mode, see add_torrent()
+        e.piece_length = ti.piece_length();
+        e.total_size = ti.total_size();
+
+        // Seed the status cache; live numbers arrive with the next state update
+        CachedStatus& cs = e.status;
+        cs = CachedStatus{};
+        cs.info.info_hash = hash;
+        cs.info.name = ti.name();
+        cs.info.size = static_cast<uint64_t>(ti.total_size());
+        if (eviction_) eviction_->touch(cs.info.name, unix_now());
+
+        // Record the metadata so later starts (and budget planning) can skip bdecoding
+        if (index_ && !index_->find(torrent_path)) {
+            TorrentMetadata meta;
+            meta.info_hash = hash;
+            meta.name = ti.name();
+            meta.total_size = static_cast<uint64_t>(ti.total_size());
+            meta.piece_length = static_cast<uint32_t>(ti.piece_length());
+            const auto& files = ti.layout();
+            meta.file_sizes.reserve(static_cast<size_t>(files.num_files()));
+            for (auto idx : files.file_range()) {
+                meta.file_sizes.push_back(static_cast<uint64_t>(files.file_size(idx)));
+            }
+            index_->put(torrent_path, std::move(meta));
+        }
+    }
+
+    // Per-file sizes and piece length for budget planning: from the metadata
+    // index when it has the torrent, otherwise from the torrent's own metadata.
+    bool load_file_layout(const InfoHash& hash, TorrentEntry& e) const {
+        BudgetPlan& plan = e.plan;
+        if (index_) {
+            auto meta = index_->find(e.path, true);
+            if (meta && meta->info_hash == hash) {
+                plan.file_sizes.assign(meta->file_sizes.begin(), meta->file_sizes.end());
+                plan.piece_length = static_cast<int>(meta->piece_length);
+                return true;
+            }
+        }
+
+        auto ti = e.handle.torrent_file();
+        if (!ti) return false;
+        const auto& files = ti->layout();
+        plan.file_sizes.clear();
+        for (auto idx : files.file_range()) plan.file_sizes.push_back(files.file_size(idx));
+        plan.piece_length = ti->piece_length();
+        return true;
+    }
+
+    // Order in which torrents draw on the download budget. Rarest-first puts
+    // the swarms with the fewest seeds ahead; otherwise map order is kept.
+    std::vector<InfoHash> budget_order() const {
+        bool rarest = (file_selection_ == FileSelection::RAREST_FIRST);
+        std::vector<std::pair<int, InfoHash>> keyed;
+        keyed.reserve(registry_.size());
+        for (const auto& [hash, e] : registry_) {
+            if (e.residency == Residency::UNLOADED) continue;
+            keyed.emplace_back(rarest ? e.status.swarm_seeds : 0, hash);
+        }
+        if (rarest) std::sort(keyed.begin(), keyed.end());
+
+        std::vector<InfoHash> order;
+        order.reserve(keyed.size());
+        for (const auto& [seeds, hash] : keyed) order.push_back(hash);
+        return order;
+    }
+
+    // Bytes in a piece; only the last one is short
+    int64_t piece_size(const InfoHash& hash, int piece) const {
+        auto it = registry_.find(hash);
+        if (it == registry_.end()) return 0;
+        const TorrentEntry& e = it->second;
+        int64_t offset = static_cast<int64_t>(piece) * e.piece_length;
+        return std::max<int64_t>(0, std::min<int64_t>(e.piece_length, e.total_size - offset));
+    }
+
+    void forget_torrent(const InfoHash& hash) {
+        auto it = registry_.find(hash);
+        if (it == registry_.end()) return;
+        TorrentEntry& e = it->second;
+        if (known_seeds_.erase(e.path) > 0) known_seeds_dirty_ = true;
+        if (e.residency == Residency::UNLOADED) unloaded_count_--;
+        totals_.remove(e.status);
+        registry_.erase(hash);
+    }
+
+    void on_torrent_added(const lt::add_torrent_alert& at) {
+        if (!at.params.ti) return;
+        InfoHash hash = key_of(at.params.ti->info_hashes());
+        auto it = registry_.find(hash);
+        if (it == registry_.end() || it->second.residency == Residency::UNLOADED) {
+            // Removed while the add was in flight
+            if (!at.error && at.handle.is_valid()) session_->remove_torrent(at.handle);
+            return;
+        }
+        if (at.error) {
+            if (!it->second.handle.is_valid()) forget_torrent(hash);
+            LEVIN_LOG("add_torrent failed: %s", at.error.message().c_str());
+            return;
+        }
+        it->second.handle = at.handle;
+    }
+
+    // --- Seeding queue ---
+
+    // Smoothed upload rate of each seed, sampled only while it holds a slot
+    // so a parked seed keeps the demand it showed last time it was active.
+    // What was uploaded since the last sample also counts towards keeping
+    // the seed's files on disk.
+    void sample_seed_demand(std::chrono::steady_clock::time_point now) {
+        int64_t wall = unix_now();
+        for (auto& [hash, e] : registry_) {
+            SeedActivity& act = e.activity;
+            if (!e.status.finished || act.parked) continue;
+            act.upload_ewma += SEED_EWMA_ALPHA * (e.status.info.upload_rate - act.upload_ewma);
+            act.last_active = now;
+            act.seen_active = true;
+            if (eviction_) {
+                const std::string& name = e.status.info.name;
+                double uploaded = static_cast<double>(e.status.info.upload_rate) *
+                                  static_cast<double>(SEED_SAMPLE_INTERVAL.count());
+                eviction_->add_demand(name, uploaded / EvictionIndex::BYTES_PER_UNIT, wall);
+                eviction_->set_swarm_seeds(name, e.status.swarm_seeds);
+            }
+        }
+    }
+
+    static int64_t unix_now() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Rank seeds by demand and rotate the seeding slots. Chosen seeds are
+    // auto-managed, so libtorrent starts them within active_seeds; the rest
+    // are paused outside the queue so they can't take a slot back. In unload
+    // mode, parked complete seeds are dropped from the session entirely and
+    // re-added when they win a slot again.
+    void schedule_seeds(std::chrono::steady_clock::time_point now) {
+        std::vector<InfoHash> hashes;
+        std::vector<SeedCandidate> candidates;
+        for (const auto& [hash, e] : registry_) {
+            if (!e.status.finished || e.residency == Residency::UNLOADING ||
+                e.residency == Residency::EVICTING) {
+                continue;
+            }
+            if (e.residency == Residency::LOADED && !e.handle.is_valid()) continue;
+
+            const SeedActivity& act = e.activity;
+            SeedCandidate c;
+            c.upload_rate = act.upload_ewma;
+            c.leechers = e.status.swarm_leechers;
+            c.seeds = e.status.swarm_seeds;
+            c.active = !act.parked;
+            c.idle_secs = act.seen_active
+                ? std::chrono::duration_cast<std::chrono::seconds>(now - act.last_active).count()
+                : INT64_MAX;
+            hashes.push_back(hash);
+            candidates.push_back(c);
+        }
+
+        auto chosen = choose_active_seeds(candidates, SEED_SLOTS, SEED_PROBE_SLOTS);
+        int parked = 0, unparked = 0, unloaded = 0;
+        for (size_t i = 0; i < hashes.size(); i++) {
+            TorrentEntry& e = registry_.find(hashes[i])->second;
+            SeedActivity& act = e.activity;
+            if (e.residency == Residency::UNLOADED) {
+                if (chosen[i]) {
+                    reload_torrent(e);
+                    unparked++;
+                }
+                continue;
+            }
+
+            lt::torrent_handle& h = e.handle;
+            if (chosen[i] && act.parked) {
+                unpark_seed(e);
+                unparked++;
+            } else if (!chosen[i] && !act.parked) {
+                h.unset_flags(lt::torrent_flags::auto_managed);
+                h.pause();
+                act.parked = true;
+                parked++;
+            }
+            // Only complete seeds: a partial torrent may get new files enabled
+            // by the budget, and that needs its handle
+            if (!chosen[i] && unload_inactive_ && e.status.info.is_seed) {
+                begin_unload(e);
+                unloaded++;
+            }
+        }
+        LEVIN_LOG("schedule_seeds: seeds=%d slots=%d parked=%d unparked=%d unloading=%d",
+                  (int)hashes.size(), SEED_SLOTS, parked, unparked, unloaded);
+    }
+
+    // --- Unloading ---
+
+    // Save resume data, then drop the torrent from the session once it's
+    // written (finish_unload). Its status, path and demand history stay.
+    void begin_unload(TorrentEntry& e) {
+        e.residency = Residency::UNLOADING;
+        if (resume_dir_.empty()) {
+            finish_unload(e);
+            return;
+        }
+        request_resume_data(e.handle, lt::torrent_handle::flush_disk_cache);
+    }
+
+    void finish_unload(const InfoHash& hash) {
+        auto it = registry_.find(hash);
+        if (it == registry_.end() || it->second.residency != Residency::UNLOADING) return;
+        finish_unload(it->second);
+    }
+
+    void finish_unload(TorrentEntry& e) {
+        if (e.handle.is_valid()) session_->remove_torrent(e.handle);
+        e.handle = lt::torrent_handle{};
+        e.resume_pending = 0;
+        e.plan = BudgetPlan{};
+        e.seed_only = false;
+        e.residency = Residency::UNLOADED;
+        unloaded_count_++;
+
+        totals_.remove(e.status);
+        e.status.info.download_rate = 0;
+        e.status.info.upload_rate = 0;
+        e.status.info.num_peers = 0;
+        totals_.add(e.status);
+    }
+
+    // --- Eviction ---
+
+    // Evicting files of a torrent that never uploaded a byte throws away
+    // what was downloaded for them
+    void count_wasted(const TorrentEntry& e, const std::vector<int>& files) {
+        if (e.status.all_time_upload > 0 || !e.handle.is_valid()) return;
+        std::vector<std::int64_t> progress;
+        e.handle.file_progress(progress, lt::torrent_handle::piece_granularity);
+        for (int idx : files) {
+            if (idx < static_cast<int>(progress.size())) {
+                wasted_bytes_ += static_cast<uint64_t>(std::max<std::int64_t>(progress[idx], 0));
+            }
+        }
+    }
+
+    // Files whose bar from the budget has run out may be funded again.
+    // Returns true if any were freed up.
+    static bool expire_evictions(TorrentEntry& e, std::chrono::steady_clock::time_point now) {
+        bool expired = false;
+        for (auto it = e.evicted.begin(); it != e.evicted.end();) {
+            if (it->second <= now) {
+                it = e.evicted.erase(it);
+                expired = true;
+            } else {
+                ++it;
+            }
+        }
+        return expired;
+    }
+
+    // Stop wanting the files queued in `evicting` or `punching` and ask for
+    // resume data.
+    // take_eviction_resume() edits it and takes the torrent out of the
+    // session; finish_eviction() has the files released once it is gone.
+    void begin_eviction(TorrentEntry& e) {
+        std::vector<lt::download_priority_t> wanted = e.handle.get_file_priorities();
+        for (const auto& [idx, until] : e.evicted) {
+            if (idx < static_cast<int>(wanted.size())) wanted[idx] = lt::dont_download;
+        }
+        e.handle.prioritize_files(wanted);
+        e.plan.valid = false;
+        e.residency = Residency::EVICTING;
+        e.eviction_skip = e.resume_pending;
+        e.resume_pending++;
+        e.handle.save_resume_data(lt::torrent_handle::flush_disk_cache |
+                                  lt::torrent_handle::save_info_dict);
+        resume_outstanding_++;
+    }
+
+    enum class ResumeReply {
+        ORDINARY,  // write it out as usual
+        EVICTION,  // answers begin_eviction()'s request
+        STALE,     // requested before the eviction began; its data predates it
+    };
+
+    // Account for a reply (or failure) to one of the torrent's resume data
+    // requests. A torrent answers them in order: the eviction's request
+    // flushes the disk cache, so nothing sent before it can overtake it.
+    // Of an evicting torrent's replies, the first eviction_skip are stale
+    // and the next is the eviction's own; anything after that is dropped
+    // too, as it could overwrite the edited resume data.
+    ResumeReply take_resume_reply(const InfoHash& hash) {
+        auto it = registry_.find(hash);
+        if (it == registry_.end()) return ResumeReply::ORDINARY;
+        TorrentEntry& e = it->second;
+        if (e.resume_pending > 0) e.resume_pending--;
+        if (e.residency != Residency::EVICTING) return ResumeReply::ORDINARY;
+        if (e.readd || e.releasing) return ResumeReply::STALE;
+        if (e.eviction_skip > 0) {
+            e.eviction_skip--;
+            return ResumeReply::STALE;
+        }
+        return ResumeReply::EVICTION;
+    }
+
+    // Mark a file unwanted and its pieces missing in resume data. Pieces it
+    // shares with a neighbouring file are lost too: their hash covers the
+    // deleted bytes.
+    static void forget_file(lt::add_torrent_params& params, int idx) {
+        if (!params.ti) return;
+        const lt::file_storage& files = params.ti->files();
+        if (idx >= files.num_files()) return;
+        std::int64_t size = files.file_size(lt::file_index_t(idx));
+        if (size <= 0) {
+            forget_pieces(params, {idx, 0, -1});
+            return;
+        }
+        int first = static_cast<int>(files.map_file(lt::file_index_t(idx), 0, 0).piece);
+        int last = static_cast<int>(files.map_file(lt::file_index_t(idx), size - 1, 0).piece);
+        forget_pieces(params, {idx, first, last});
+    }
+
+    // Mark the range's file unwanted and its pieces missing in resume data
+    static void forget_pieces(lt::add_torrent_params& params, const PieceRange& r) {
+        if (!params.ti) return;
+        int num_files = params.ti->files().num_files();
+        if (r.file >= num_files) return;
+        params.file_priorities.resize(static_cast<size_t>(num_files), lt::default_priority);
+        params.file_priorities[r.file] = lt::dont_download;
+        for (int p = r.first; p <= r.last; p++) {
+            lt::piece_index_t piece(p);
+            if (p < params.have_pieces.size()) params.have_pieces.clear_bit(piece);
+            if (p < params.verified_pieces.size()) params.verified_pieces.clear_bit(piece);
+            params.unfinished_pieces.erase(piece);
+        }
+    }
+
+    // The eviction's resume data (see take_resume_reply): forget the
+    // evicted files, persist that, and remove the torrent
+    void take_eviction_resume(const InfoHash& hash, const lt::add_torrent_params& params) {
+        auto it = registry_.find(hash);
+        if (it == registry_.end() || it->second.residency != Residency::EVICTING) return;
+        TorrentEntry& e = it->second;
+        if (e.readd) return;
+
+        lt::add_torrent_params edited = params;
+        if (!edited.ti) {
+            auto ti = e.handle.torrent_file();
+            if (ti) edited.ti = std::make_shared<lt::torrent_info>(*ti);
+        }
+        for (int idx : e.evicting) forget_file(edited, idx);
+        for (const PieceRange& r : e.punching) forget_pieces(edited, r);
+        write_resume_data(edited);
+        e.readd = std::move(edited);
+        session_->remove_torrent(e.handle);
+    }
+
+    // The torrent has let go of its files: have the evicted ones unlinked
+    // or punched. finish_releases() adds it back once they are.
+    void finish_eviction(const InfoHash& hash) {
+        auto it = registry_.find(hash);
+        if (it == registry_.end() || it->second.residency != Residency::EVICTING) return;
+        TorrentEntry& e = it->second;
+        if (!e.readd || e.releasing) return;
+        start_release(hash, e);
+    }
+
+    // Without resume data to edit, release the files under the running
+    // torrent; finish_releases() has it check what is left
+    void evict_in_place(const InfoHash& hash) {
+        auto it = registry_.find(hash);
+        if (it == registry_.end() || it->second.residency != Residency::EVICTING) return;
+        TorrentEntry& e = it->second;
+        if (e.readd || e.releasing) return;
+        start_release(hash, e);
+    }
+
+    // Add an evicted torrent back from its edited resume data, seeding the rest
+    void readd_evicted(TorrentEntry& e) {
+        lt::add_torrent_params params = std::move(*e.readd);
+        e.readd.reset();
+        e.handle = lt::torrent_handle{};
+        e.resume_pending = 0;  // the removed torrent answers nothing more
+        e.plan = BudgetPlan{};
+        e.residency = Residency::LOADED;
+        e.seed_only = downloads_paused_;
+        params.flags &= ~lt::torrent_flags::upload_mode;
+        if (downloads_paused_) params.flags |= lt::torrent_flags::upload_mode;
+        // The handle stays invalid until the add_torrent_alert arrives
+        session_->async_add_torrent(std::move(params));
+    }
+
+    // File work for one torrent's eviction, done by the disk job runner
+    struct FileRelease {
+        struct Hole {
+            std::string path;
+            int64_t offset;
+            int64_t length;
+            int pieces;
+        };
+        std::string name;  // for the log
+        std::vector<std::string> unlink;
+        std::vector<Hole> punch;
+    };
+
+    // Finished release jobs, shared with the threads that run them
+    struct ReleaseResults {
+        std::mutex mutex;
+        std::vector<InfoHash> done;
+        bool failed = false;  // something counted as freed wasn't
+    };
+
+    // Turn the entry's `evicting` and `punching` into a release job and hand
+    // it to the disk job runner
+    void start_release(const InfoHash& hash, TorrentEntry& e) {
+        FileRelease release;
+        release.name = e.status.info.name;
+        std::shared_ptr<const lt::torrent_info> ti;
+        fs::path root(data_dir_);
+        if (e.readd) {
+            ti = e.readd->ti;
+            if (!e.readd->save_path.empty()) root = e.readd->save_path;
+        } else if (e.handle.is_valid()) {
+            ti = e.handle.torrent_file();
+        }
+        if (ti) plan_release(e, *ti, root, release);
+        e.evicting.clear();
+        e.punching.clear();
+        e.releasing = true;
+
+        std::shared_ptr<ReleaseResults> results = release_results_;
+        auto job = [hash, release = std::move(release), results] {
+            bool ok = run_release(release);
+            std::lock_guard<std::mutex> lock(results->mutex);
+            results->done.push_back(hash);
+            if (!ok) results->failed = true;
+        };
+        if (disk_job_runner_) {
+            disk_job_runner_(std::move(job));
+        } else {
+            job();
+        }
+    }
+
+    // Paths to unlink for `evicting` and ranges to punch for `punching`.
+    // Ranges in files that go whole are skipped.
+    static void plan_release(const TorrentEntry& e, const lt::torrent_info& ti, const fs::path& root,
+                             FileRelease& out) {
+        const lt::file_storage& files = ti.files();
+        for (int idx : e.evicting) {
+            if (idx >= files.num_files()) continue;
+            out.unlink.push_back((root / files.file_path(lt::file_index_t(idx))).string());
+        }
+
+        int64_t plen = ti.piece_length();
+        for (const PieceRange& r : e.punching) {
+            if (r.file >= files.num_files()) continue;
+            lt::file_index_t idx(r.file);
+            if (std::find(e.evicting.begin(), e.evicting.end(), r.file) != e.evicting.end()) continue;
+            int64_t begin = files.file_offset(idx);
+            int64_t offset = r.first * plen - begin;
+            int64_t length = std::min<int64_t>((r.last + 1) * plen, begin + files.file_size(idx)) -
+                             r.first * plen;
+            out.punch.push_back({(root / files.file_path(idx)).string(), offset, length,
+                                 r.last - r.first + 1});
+        }
+    }
+
+    // Runs on the disk job runner's thread. Returns false if anything
+    // failed: it was already counted as freed, so usage is measured again.
+    static bool run_release(const FileRelease& release) {
+        bool ok = true;
+        int removed = 0;
+        for (const std::string& path : release.unlink) {
+            std::error_code ec;
+            if (fs::remove(path, ec)) removed++;
+            if (ec) ok = false;
+        }
+        int punched = 0;
+        for (const FileRelease::Hole& h : release.punch) {
+            if (punch_hole(h.path, static_cast<uint64_t>(h.offset), static_cast<uint64_t>(h.length))) {
+                punched += h.pieces;
+            } else {
+                ok = false;
+            }
+        }
+        LEVIN_LOG("evicted %d files and %d pieces from %s", removed, punched, release.name.c_str());
+        return ok;
+    }
+
+    // Move on with torrents whose release jobs have finished: add them back,
+    // or have them recheck if they never left the session
+    void finish_releases() {
+        std::vector<InfoHash> done;
+        {
+            std::lock_guard<std::mutex> lock(release_results_->mutex);
+            done.swap(release_results_->done);
+        }
+        for (const InfoHash& hash : done) {
+            auto it = registry_.find(hash);
+            if (it == registry_.end()) continue;
+            TorrentEntry& e = it->second;
+            e.releasing = false;
+            bool more = !e.evicting.empty() || !e.punching.empty();  // evicted again meanwhile
+            if (e.readd) {
+                if (more) {
+                    start_release(hash, e);
+                } else {
+                    readd_evicted(e);
+                }
+            } else {
+                e.residency = Residency::LOADED;
+                e.handle.force_recheck();
+                if (more) begin_eviction(e);
+            }
+        }
+    }
+
+    // Paths in the data directory -> the torrent in the session that owns
+    // them and the file's index in it. Torrent layouts are read on first use.
+    struct OwnerLookup {
+        std::unordered_map<std::string, InfoHash> by_name;  // top-level entry -> torrent
+        std::unordered_map<std::string, std::unordered_map<std::string, int>> layouts;
+    };
+
+    OwnerLookup make_owner_lookup() const {
+        OwnerLookup lookup;
+        for (const auto& [hash, e] : registry_) {
+            if (e.residency == Residency::EVICTING ||
+                (e.residency == Residency::LOADED && e.handle.is_valid())) {
+                lookup.by_name.emplace(e.status.info.name, hash);
+            }
+        }
+        return lookup;
+    }
+
+    std::optional<std::pair<InfoHash, int>> find_owner(OwnerLookup& lookup, const std::string& path) const {
+        std::string rel = fs::path(path).lexically_relative(data_dir_).generic_string();
+        auto owner = lookup.by_name.find(rel.substr(0, rel.find('/')));
+        if (owner == lookup.by_name.end()) return std::nullopt;
+
+        auto [layout, fresh] = lookup.layouts.try_emplace(owner->first);
+        if (fresh) {
+            const TorrentEntry& e = registry_.find(owner->second)->second;
+            // Once removed for eviction, the handle is gone but the resume data has the layout
+            std::shared_ptr<const lt::torrent_info> ti =
+                e.readd ? e.readd->ti : (e.handle.is_valid() ? e.handle.torrent_file() : nullptr);
+            if (ti) {
+                const auto& files = ti->files();
+                for (auto idx : files.file_range()) {
+                    layout->second.emplace(files.file_path(idx), static_cast<int>(idx));
+                }
+            }
+        }
+        auto file = layout->second.find(rel);
+        if (file == layout->second.end()) return std::nullopt;  // not one of its files
+        return std::make_pair(owner->second, file->second);
+    }
+
+    // Parse and add an unloaded torrent again; register_torrent() marks it
+    // loaded once the pool has parsed it
+    void reload_torrent(TorrentEntry& e) {
+        if (!parse_pool_) return;
+        parse_pool_->submit(e.path);
+        e.activity.parked = false;
+    }
+
+    void end_soft_pause() {
+        if (!soft_paused_) return;
+        soft_paused_ = false;
+        lt::settings_pack sp;
+        sp.set_int(lt::settings_pack::unchoke_slots_limit, saved_unchoke_slots_);
+        sp.set_int(lt::settings_pack::upload_rate_limit, upload_rate_limit_);
+        session_->apply_settings(std::move(sp));
+        if (soft_paused_downloads_) resume_downloads();
+    }
+
+    // Torrents libtorrent put in upload mode itself (disk errors) are left
+    // alone, so resume_downloads() doesn't take them out early
+    bool enter_seed_only(TorrentEntry& e) {
+        if (e.seed_only || e.status.upload_mode || !e.handle.is_valid()) return false;
+        e.handle.set_flags(lt::torrent_flags::upload_mode);
+        e.seed_only = true;
+        e.status.upload_mode = true;
+        return true;
+    }
+
+    void unpark_seed(TorrentEntry& e) {
+        if (!e.activity.parked) return;
+        e.handle.set_flags(lt::torrent_flags::auto_managed);
+        e.activity.parked = false;
+    }
+
+    // --- Fast resume ---
+
+    std::string resume_path(const InfoHash& hash) const {
+        return resume_dir_ + "/" + hash.to_hex() + ".resume";
+    }
+
+    void request_resume_data(const lt::torrent_handle& h, lt::resume_data_flags_t flags) {
+        if (resume_dir_.empty() || !h.is_valid()) return;
+        auto it = registry_.find(key_of(h.info_hashes()));
+        if (it != registry_.end()) it->second.resume_pending++;
+        h.save_resume_data(flags);
+        resume_outstanding_++;
+    }
+
+    // Torrents on their way out already have a request of their own pending
+    void checkpoint_resume_data() {
+        for (const auto& [hash, e] : registry_) {
+            if (e.residency == Residency::EVICTING || e.residency == Residency::UNLOADING) continue;
+            request_resume_data(e.handle, lt::torrent_handle::only_if_modified);
+        }
+    }
+
+    // Collect resume data for every torrent and wait for it to be written.
+    // Bounded so a wedged disk cannot block shutdown forever.
+    void save_all_resume_data() {
+        if (!session_ || resume_dir_.empty()) return;
+
+        session_->pause();
+        for (const auto& [hash, e] : registry_) {
+            request_resume_data(e.handle, lt::torrent_handle::flush_disk_cache);
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + RESUME_SAVE_TIMEOUT;
+        while (resume_outstanding_ > 0 && std::chrono::steady_clock::now() < deadline) {
+            if (!session_->wait_for_alert(lt::seconds(1))) continue;
+            dispatch_alerts();
+        }
+        if (resume_outstanding_ > 0) {
+            LEVIN_LOG("save_all_resume_data: timed out with %d torrents pending", resume_outstanding_);
+        }
+    }
+
+    void write_resume_data(const lt::add_torrent_params& params) {
+        if (resume_dir_.empty()) return;
+        std::string path = resume_path(key_of(params.info_hashes));
+        std::vector<char> buf = lt::write_resume_data_buf(params);
+
+        // Write to a temp file and rename, so a crash never leaves a torn file
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            if (!f.is_open()) return;
+            f.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+            if (!f) return;
+        }
+        std::error_code ec;
+        fs::rename(tmp, path, ec);
+    }
+
+    // Remember which torrent files had everything they wanted when their
+    // resume data was last saved; staged startup adds these first.
+    void note_seed_state(const InfoHash& hash) {
+        auto it = registry_.find(hash);
+        if (it == registry_.end()) return;
+        const TorrentEntry& e = it->second;
+        bool changed = e.status.finished ? known_seeds_.insert(e.path).second
+                                         : known_seeds_.erase(e.path) > 0;
+        if (changed) known_seeds_dirty_ = true;
+    }
+
+    void load_known_seeds() {
+        known_seeds_.clear();
+        std::ifstream f(resume_dir_ + "/seeds.list");
+        std::string line;
+        while (std::getline(f, line)) {
+            if (!line.empty()) known_seeds_.insert(line);
+        }
+    }
+
+    void save_known_seeds() const {
+        if (resume_dir_.empty()) return;
+        std::string path = resume_dir_ + "/seeds.list";
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream f(tmp, std::ios::trunc);
+            if (!f.is_open()) return;
+            for (const auto& p : known_seeds_) f << p << '\n';
+            if (!f) return;
+        }
+        std::error_code ec;
+        fs::rename(tmp, path, ec);
+    }
+
+    std::optional<lt::add_torrent_params> load_resume_data(const InfoHash& hash) const {
+        if (resume_dir_.empty()) return std::nullopt;
+        std::ifstream f(resume_path(hash), std::ios::binary);
+        if (!f.is_open()) return std::nullopt;
+        std::vector<char> buf((std::istreambuf_iterator<char>(f)),
+                               std::istreambuf_iterator<char>());
+        if (buf.empty()) return std::nullopt;
+
+        lt::error_code ec;
+        lt::add_torrent_params params = lt::read_resume_data(buf, ec);
+        if (ec) return std::nullopt;
+        return params;
+    }
+
+    void update_cached_status(const lt::torrent_status& st) {
+        auto it = registry_.find(key_of(st.info_hashes));
+        if (it == registry_.end()) return;  // removed after the update was posted
+
+        CachedStatus& cs = it->second.status;
+        totals_.remove(cs);
+        cs.info.downloaded = static_cast<uint64_t>(st.total_done);
+        cs.info.uploaded = static_cast<uint64_t>(st.total_upload);
+        cs.all_time_upload = static_cast<uint64_t>(std::max<std::int64_t>(st.all_time_upload, 0));
+        cs.info.download_rate = st.download_rate;
+        cs.info.upload_rate = st.upload_rate;
+        cs.info.num_peers = st.num_peers;
+        cs.info.progress = static_cast<double>(st.progress);
+        cs.info.is_seed = st.is_seeding;
+        cs.info.size = static_cast<uint64_t>(st.total_wanted);
+        cs.finished = st.is_finished;
+        cs.upload_mode = static_cast<bool>(st.flags & lt::torrent_flags::upload_mode);
+        cs.swarm_seeds = swarm_seed_count(st.num_complete, st.num_seeds);
+        cs.swarm_leechers = st.num_incomplete >= 0 ? st.num_incomplete
+                                                   : std::max(st.num_peers - st.num_seeds, 0);
+        totals_.add(cs);
+    }
+
+    // Indices into session_stats_alert::counters(), resolved once by name.
+    // Names this libtorrent build doesn't know resolve to -1 and read as 0.
+    struct MetricIndices {
+        int net_recv_bytes = lt::find_metric_idx("net.recv_bytes");
+        int net_sent_bytes = lt::find_metric_idx("net.sent_bytes");
+        int payload_recv_bytes = lt::find_metric_idx("net.recv_payload_bytes");
+        int payload_sent_bytes = lt::find_metric_idx("net.sent_payload_bytes");
+        int disk_queued_bytes = lt::find_metric_idx("disk.queued_write_bytes");
+        int disk_queued_jobs = lt::find_metric_idx("disk.queued_disk_jobs");
+        int peers_connected = lt::find_metric_idx("peer.num_peers_connected");
+        int peers_half_open = lt::find_metric_idx("peer.num_peers_half_open");
+        int peers_tcp = lt::find_metric_idx("peer.num_tcp_peers");
+        int peers_utp = lt::find_metric_idx("peer.num_utp_peers");
+        int peers_ssl = lt::find_metric_idx("peer.num_ssl_peers");
+        int peers_webrtc = lt::find_metric_idx("peer.num_rtc_peers");
+    };
+
+    void update_metrics(lt::span<std::int64_t const> counters) {
+        auto get = [&counters](int idx) -> std::int64_t {
+            if (idx < 0 || idx >= static_cast<int>(counters.size())) return 0;
+            return std::max<std::int64_t>(counters[idx], 0);
+        };
+        metrics_.net_recv_bytes = static_cast<uint64_t>(get(metric_idx_.net_recv_bytes));
+        metrics_.net_sent_bytes = static_cast<uint64_t>(get(metric_idx_.net_sent_bytes));
+        metrics_.payload_recv_bytes = static_cast<uint64_t>(get(metric_idx_.payload_recv_bytes));
+        metrics_.payload_sent_bytes = static_cast<uint64_t>(get(metric_idx_.payload_sent_bytes));
+        metrics_.disk_queued_bytes = static_cast<uint64_t>(get(metric_idx_.disk_queued_bytes));
+        metrics_.disk_queued_jobs = static_cast<int>(get(metric_idx_.disk_queued_jobs));
+        metrics_.peers_connected = static_cast<int>(get(metric_idx_.peers_connected));
+        metrics_.peers_half_open = static_cast<int>(get(metric_idx_.peers_half_open));
+        metrics_.peers_tcp = static_cast<int>(get(metric_idx_.peers_tcp));
+        metrics_.peers_utp = static_cast<int>(get(metric_idx_.peers_utp));
+        metrics_.peers_ssl = static_cast<int>(get(metric_idx_.peers_ssl));
+        metrics_.peers_webrtc = static_cast<int>(get(metric_idx_.peers_webrtc));
+    }
+
+    // Registry key: the v1 hash of v1 and hybrid torrents, the full v2 hash
+    // of v2-only ones
+    static InfoHash key_of(const lt::info_hash_t& ih) {
+        if (ih.has_v1()) return InfoHash(ih.v1.data(), ih.v1.size());
+        return InfoHash(ih.v2.data(), ih.v2.size());
     }
 
     std::unique_ptr<lt::session> session_;
-    std::unordered_map<std::string, lt::torrent_handle> torrents_;
+    InfoHashMap<TorrentEntry> registry_;
+    size_t unloaded_count_ = 0;
+    StatusTotals totals_;
+    MetricIndices metric_idx_;
+    SessionMetrics metrics_;
+    DiskUsageDelta disk_delta_;  // since the last take_disk_usage_delta()
+    DiskJobRunner disk_job_runner_;
+    std::shared_ptr<ReleaseResults> release_results_ = std::make_shared<ReleaseResults>();
     std::string data_dir_;
+    bool punch_holes_ = false;  // supported by data_dir_'s filesystem
     int port_ = 6881;
     std::string stun_server_ = "stun.l.google.com:19302";
     bool running_ = false;
     bool paused_ = false;
     int download_rate_limit_ = 0;
+    int upload_rate_limit_ = 0;
+    bool downloads_paused_ = false;
+    bool soft_paused_ = false;
+    bool soft_paused_downloads_ = false;  // soft pause put the torrents in upload mode
+    int saved_unchoke_slots_ = 8;
     std::string pending_state_path_;
+
+    static constexpr int PARSED_ADDS_PER_TICK = 256;
+    std::unique_ptr<TorrentParsePool> parse_pool_;
+    TorrentIndex* index_ = nullptr;
+    EvictionIndex* eviction_ = nullptr;
+    std::chrono::seconds eviction_cooldown_{0};  // how long evicted files stay unfunded
+    uint64_t wasted_bytes_ = 0;  // see wasted_bytes()
+
+    static constexpr std::chrono::minutes AVAILABILITY_REFRESH{10};
+    FileSelection file_selection_ = FileSelection::RANDOM;
+    IoProfile io_profile_ = IoProfile::AUTO;
+    DiskIoSettings io_settings_ = io_settings_for(IoProfile::AUTO);
+
+    uint64_t memory_budget_ = 0;  // 0 = unlimited
+    MemorySettings memory_settings_ = derive_memory_settings(0, 0, 0, io_settings_);
+    int memory_torrents_ = 0;     // torrent count memory_settings_ was derived for
+
+    static constexpr int ACTIVE_DOWNLOADS = 8;
+    static constexpr int SEED_SLOTS = 48;
+    static constexpr int SEED_PROBE_SLOTS = 8;   // rotated through idle seeds
+    static constexpr double SEED_EWMA_ALPHA = 0.2;
+    static constexpr std::chrono::seconds SEED_SAMPLE_INTERVAL{30};
+    static constexpr std::chrono::minutes SEED_ROTATION_INTERVAL{10};
+    static constexpr std::chrono::minutes SEED_FIRST_ROTATION{1};
+
+    bool unload_inactive_ = false;
+    std::chrono::steady_clock::time_point last_seed_sample_ = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last_seed_rotation_ = std::chrono::steady_clock::now();
+
+    static constexpr std::chrono::minutes RESUME_CHECKPOINT_INTERVAL{5};
+    static constexpr std::chrono::seconds RESUME_SAVE_TIMEOUT{30};
+    std::string resume_dir_;
+    int resume_outstanding_ = 0;
+    std::unordered_set<std::string> known_seeds_;  // .torrent paths
+    bool known_seeds_dirty_ = false;
+    std::chrono::steady_clock::time_point last_resume_checkpoint_ = std::chrono::steady_clock::now();
 };
 
 // Factory function to create the real session
@@ -135,30 +135,6 @@ void TorrentWatcher::poll() {
     }
 }
 
-void TorrentWatcher::scan_existing() {
-    if (impl_->directory.empty()) return;
-
-    namespace fs = std::filesystem;
-    std::error_code ec;
-
-    // Collect and sort for deterministic ordering
-    std::vector<std::string> paths;
-    for (const auto& entry : fs::directory_iterator(impl_->directory, ec)) {
-        if (ec) break;
-        if (entry.is_regular_file() && has_torrent_extension(entry.path().string())) {
-            paths.push_back(entry.path().string());
-        }
-    }
-
-    std::sort(paths.begin(), paths.end());
-
-    for (const auto& path : paths) {
-        if (impl_->on_add) {
-            impl_->on_add(path);
-        }
-    }
-}
-
 #elif defined(__APPLE__) // macOS: FSEvents
 
 // FSEvents delivers events asynchronously on a dispatch queue.  We accumulate
@@ -298,29 +274,6 @@ void TorrentWatcher::poll() {
     }
 }
 
-void TorrentWatcher::scan_existing() {
-    if (impl_->directory.empty()) return;
-
-    namespace fs = std::filesystem;
-    std::error_code ec;
-
-    std::vector<std::string> paths;
-    for (const auto& entry : fs::directory_iterator(impl_->directory, ec)) {
-        if (ec) break;
-        if (entry.is_regular_file() && has_torrent_extension(entry.path().string())) {
-            paths.push_back(entry.path().string());
-        }
-    }
-
-    std::sort(paths.begin(), paths.end());
-
-    for (const auto& path : paths) {
-        if (impl_->on_add) {
-            impl_->on_add(path);
-        }
-    }
-}
-
 #else // Fallback (no-op) for platforms without file watching
 
 struct TorrentWatcher::Impl {
@@ -349,13 +302,16 @@ void TorrentWatcher::stop() {}
 
 void TorrentWatcher::poll() {}
 
-void TorrentWatcher::scan_existing() {
-    if (impl_->directory.empty()) return;
+#endif
+
+// Shared by all platforms: every Impl keeps the watched directory.
+std::vector<std::string> TorrentWatcher::list_existing() const {
+    std::vector<std::string> paths;
+    if (impl_->directory.empty()) return paths;
 
     namespace fs = std::filesystem;
     std::error_code ec;
 
-    std::vector<std::string> paths;
     for (const auto& entry : fs::directory_iterator(impl_->directory, ec)) {
         if (ec) break;
         if (entry.is_regular_file() && has_torrent_extension(entry.path().string())) {
@@ -363,15 +319,17 @@ void TorrentWatcher::scan_existing() {
         }
     }
 
+    // Sort for deterministic ordering
     std::sort(paths.begin(), paths.end());
+    return paths;
+}
 
-    for (const auto& path : paths) {
+void TorrentWatcher::scan_existing() {
+    for (const auto& path : list_existing()) {
         if (impl_->on_add) {
             impl_->on_add(path);
         }
     }
 }
 
-#endif
-
 } // namespace levin
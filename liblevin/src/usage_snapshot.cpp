@@ -0,0 +1,103 @@
+#include "usage_snapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace levin {
+
+// File format: header, data directory, then one record per top-level entry.
+// Header: magic "LVUS" (4), version (4), usage (8), file_count (8),
+//         entry count (8), data directory length (4)
+// Record: usage (8), newest_mtime (8), file_count (4), name length (4), name
+static const char MAGIC[4] = {'L', 'V', 'U', 'S'};
+static const uint32_t VERSION = 1;
+static const size_t HEADER_SIZE = 4 + 4 + 8 + 8 + 8 + 4;
+static const size_t RECORD_HEADER_SIZE = 8 + 8 + 4 + 4;
+
+template <typename T>
+static void put(std::string& out, T v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <typename T>
+static bool get(const std::string& in, size_t& off, T& v) {
+    if (off + sizeof(v) > in.size()) return false;
+    std::memcpy(&v, in.data() + off, sizeof(v));
+    off += sizeof(v);
+    return true;
+}
+
+bool UsageSnapshot::load(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) return false;
+    std::string buf((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    if (buf.size() < HEADER_SIZE || std::memcmp(buf.data(), MAGIC, 4) != 0) return false;
+
+    size_t off = 4;
+    uint32_t ver, dir_len;
+    uint64_t total, files, count;
+    get(buf, off, ver);
+    if (ver != VERSION) return false;
+    get(buf, off, total);
+    get(buf, off, files);
+    get(buf, off, count);
+    get(buf, off, dir_len);
+    if (off + dir_len > buf.size()) return false;
+    std::string dir = buf.substr(off, dir_len);
+    off += dir_len;
+
+    std::vector<TopLevelUsage> loaded;
+    for (uint64_t i = 0; i < count; i++) {
+        if (off + RECORD_HEADER_SIZE > buf.size()) return false;
+        TopLevelUsage e;
+        uint32_t entry_files, name_len;
+        get(buf, off, e.usage);
+        get(buf, off, e.newest_mtime);
+        get(buf, off, entry_files);
+        get(buf, off, name_len);
+        if (off + name_len > buf.size()) return false;
+        e.file_count = static_cast<int>(entry_files);
+        e.name = buf.substr(off, name_len);
+        off += name_len;
+        loaded.push_back(std::move(e));
+    }
+
+    data_directory = std::move(dir);
+    usage = total;
+    file_count = static_cast<int>(files);
+    entries = std::move(loaded);
+    return true;
+}
+
+bool UsageSnapshot::save(const std::string& path) const {
+    std::string buf;
+    buf.append(MAGIC, 4);
+    put(buf, VERSION);
+    put(buf, usage);
+    put(buf, static_cast<uint64_t>(file_count));
+    put(buf, static_cast<uint64_t>(entries.size()));
+    put(buf, static_cast<uint32_t>(data_directory.size()));
+    buf.append(data_directory);
+    for (const auto& e : entries) {
+        put(buf, e.usage);
+        put(buf, e.newest_mtime);
+        put(buf, static_cast<uint32_t>(e.file_count));
+        put(buf, static_cast<uint32_t>(e.name.size()));
+        buf.append(e.name);
+    }
+
+    // Write the new snapshot beside the old one, so a crash mid-write
+    // leaves the previous snapshot intact
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f.is_open()) return false;
+        f.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!f) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+} // namespace levin
@@ -1,9 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
 #include "liblevin.h"
 
+#include <chrono>
 #include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <string>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -119,6 +122,62 @@ TEST_CASE("Battery loss transitions to PAUSED", "[capi]") {
     levin_destroy(ctx);
 }
 
+TEST_CASE("Short PAUSED periods soft-pause until the grace period ends", "[capi]") {
+    TestFixture f;
+    f.config.pause_grace_secs = 3;
+    levin_t* ctx = levin_create(&f.config);
+    levin_start(ctx);
+    levin_set_enabled(ctx, 1);
+    levin_update_battery(ctx, 1);
+    levin_update_network(ctx, 1, 0);
+    levin_update_storage(ctx, 500*GB, 400*GB);
+    levin_tick(ctx);
+
+    levin_update_battery(ctx, 0);
+    levin_tick(ctx);
+    REQUIRE(levin_get_status(ctx).state == LEVIN_STATE_PAUSED);
+    REQUIRE(levin_get_status(ctx).soft_paused == 1);
+
+    // Power back within the grace period: straight back to IDLE
+    levin_update_battery(ctx, 1);
+    levin_tick(ctx);
+    REQUIRE(levin_get_status(ctx).state == LEVIN_STATE_IDLE);
+    REQUIRE(levin_get_status(ctx).soft_paused == 0);
+
+    // Unplugged for longer: the soft pause becomes a full pause
+    levin_update_battery(ctx, 0);
+    for (int i = 0; i < 3; i++) levin_tick(ctx);
+    REQUIRE(levin_get_status(ctx).state == LEVIN_STATE_PAUSED);
+    REQUIRE(levin_get_status(ctx).soft_paused == 0);
+
+    levin_stop(ctx);
+    levin_destroy(ctx);
+}
+
+TEST_CASE("Re-enabling right after disabling is not held by the dwell time", "[capi]") {
+    TestFixture f;
+    f.config.state_min_dwell_secs = 600;
+    levin_t* ctx = levin_create(&f.config);
+    levin_start(ctx);
+    levin_set_enabled(ctx, 1);
+    levin_update_battery(ctx, 1);
+    levin_update_network(ctx, 1, 0);
+    levin_update_storage(ctx, 500*GB, 400*GB);
+    levin_tick(ctx);
+    REQUIRE(levin_get_status(ctx).state == LEVIN_STATE_IDLE);
+
+    levin_set_enabled(ctx, 0);
+    levin_tick(ctx);
+    REQUIRE(levin_get_status(ctx).state == LEVIN_STATE_OFF);
+
+    levin_set_enabled(ctx, 1);
+    levin_tick(ctx);
+    REQUIRE(levin_get_status(ctx).state == LEVIN_STATE_IDLE);
+
+    levin_stop(ctx);
+    levin_destroy(ctx);
+}
+
 TEST_CASE("run_on_battery=true ignores battery state", "[capi]") {
     TestFixture f;
     f.config.run_on_battery = 1;
@@ -147,6 +206,32 @@ TEST_CASE("Torrent list is initially empty", "[capi]") {
     levin_destroy(ctx);
 }
 
+TEST_CASE("Disk usage is restored from the snapshot on restart", "[capi]") {
+    TestFixture f;
+    levin_t* ctx = levin_create(&f.config);
+    levin_start(ctx);
+    {
+        std::ofstream book(std::string(f.config.data_directory) + "/book.epub", std::ios::binary);
+        std::string data(100000, 'x');
+        book.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    levin_update_storage(ctx, 500*GB, 400*GB);
+    uint64_t usage = levin_get_status(ctx).disk_usage;
+    REQUIRE(usage >= 100000);
+    REQUIRE(levin_get_status(ctx).file_count == 1);
+    levin_stop(ctx);
+    levin_destroy(ctx);
+
+    // Known before any disk check
+    ctx = levin_create(&f.config);
+    levin_start(ctx);
+    auto s = levin_get_status(ctx);
+    REQUIRE(s.disk_usage == usage);
+    REQUIRE(s.file_count == 1);
+    levin_stop(ctx);
+    levin_destroy(ctx);
+}
+
 TEST_CASE("Status reports disk usage and budget", "[capi]") {
     TestFixture f;
     levin_t* ctx = levin_create(&f.config);
@@ -164,3 +249,67 @@ TEST_CASE("Status reports disk usage and budget", "[capi]") {
     levin_stop(ctx);
     levin_destroy(ctx);
 }
+
+TEST_CASE("Over budget: downloads stop at once, files go in the background", "[capi]") {
+    TestFixture f;
+    constexpr uint64_t MB = 1024ULL * 1024;
+    f.config.max_storage_bytes = 4 * MB;
+    fs::create_directories(f.config.data_directory);
+    for (int i = 0; i < 4; i++) {
+        std::ofstream out(fs::path(f.config.data_directory) / ("f" + std::to_string(i)), std::ios::binary);
+        out << std::string(2 * MB, 'x');
+    }
+
+    levin_t* ctx = levin_create(&f.config);
+    levin_start(ctx);
+    levin_update_storage(ctx, 500*GB, 400*GB);
+
+    // Nothing may be downloaded while space is being freed
+    auto s = levin_get_status(ctx);
+    REQUIRE(s.over_budget == 1);
+    REQUIRE(s.disk_budget == 0);
+
+    // The worker deletes on its own thread; tick until it is done
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (levin_get_status(ctx).eviction_pending > 0 && std::chrono::steady_clock::now() < deadline) {
+        levin_tick(ctx);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    s = levin_get_status(ctx);
+    REQUIRE(s.eviction_pending == 0);
+    REQUIRE(s.disk_usage <= 4 * MB);
+
+    int left = 0;
+    for (const auto& e : fs::directory_iterator(f.config.data_directory)) {
+        if (e.is_regular_file()) left++;
+    }
+    REQUIRE(left <= 2);
+
+    levin_stop(ctx);
+    levin_destroy(ctx);
+}
+
+TEST_CASE("Existing torrents are added in stages after start", "[capi]") {
+    TestFixture f;
+    fs::create_directories(f.config.watch_directory);
+    for (int i = 0; i < 3; i++) {
+        std::ofstream(fs::path(f.config.watch_directory) / ("t" + std::to_string(i) + ".torrent")) << "x";
+    }
+
+    levin_t* ctx = levin_create(&f.config);
+    REQUIRE(levin_start(ctx) == 0);
+
+    // Start returns before anything is added
+    auto s = levin_get_status(ctx);
+    REQUIRE(s.torrent_count == 0);
+    REQUIRE(s.startup_total == 3);
+    REQUIRE(s.startup_pending == 3);
+
+    levin_tick(ctx);
+    s = levin_get_status(ctx);
+    REQUIRE(s.torrent_count == 3);
+    REQUIRE(s.startup_pending == 0);
+
+    levin_stop(ctx);
+    levin_destroy(ctx);
+}
@@ -0,0 +1,154 @@
+#include <catch2/catch_test_macros.hpp>
+#include "data_dir_tracker.h"
+#include "dir_scanner.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace levin;
+
+#ifdef __linux__
+
+// --- Test Helpers ---
+
+class TempDir {
+public:
+    TempDir() {
+        path_ = fs::temp_directory_path() / ("levin_tracker_test_" + std::to_string(counter_++));
+        fs::remove_all(path_);
+        fs::create_directories(path_);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+    }
+    const fs::path& path() const { return path_; }
+
+private:
+    fs::path path_;
+    static inline int counter_ = 0;
+};
+
+static void write_file(const fs::path& path, size_t size, bool append = false) {
+    std::ofstream f(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    std::string data(size, 'x');
+    f.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// Tracker totals must match a fresh walk of the same tree
+static void require_matches_scan(const DataDirTracker& tracker, const fs::path& root) {
+    DirScan scan = scan_directory(root.string());
+    REQUIRE(tracker.usage() == scan.usage);
+    REQUIRE(tracker.file_count() == scan.file_count);
+}
+
+// Poll until the background measurement is adopted
+static bool wait_measured(DataDirTracker& tracker) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    for (;;) {
+        tracker.poll();
+        if (!tracker.measuring()) return tracker.active();
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// --- Tests ---
+
+TEST_CASE("Tracker measures the existing tree on start", "[tracker]") {
+    TempDir dir;
+    fs::create_directories(dir.path() / "a" / "b");
+    write_file(dir.path() / "top.bin", 5000);
+    write_file(dir.path() / "a" / "b" / "deep.bin", 9000);
+    write_file(dir.path() / "a" / "empty.bin", 0);
+
+    DataDirTracker tracker;
+    REQUIRE(tracker.start(dir.path().string()) == 0);
+    REQUIRE(wait_measured(tracker));
+    REQUIRE(tracker.file_count() == 2);
+    require_matches_scan(tracker, dir.path());
+}
+
+TEST_CASE("Tracker follows files being added, grown and deleted", "[tracker]") {
+    TempDir dir;
+    DataDirTracker tracker;
+    REQUIRE(tracker.start(dir.path().string()) == 0);
+    REQUIRE(wait_measured(tracker));
+    REQUIRE(tracker.usage() == 0);
+
+    write_file(dir.path() / "one.bin", 8192);
+    write_file(dir.path() / "two.bin", 4096);
+    tracker.poll();
+    REQUIRE(tracker.file_count() == 2);
+    require_matches_scan(tracker, dir.path());
+
+    write_file(dir.path() / "one.bin", 65536, true);
+    tracker.poll();
+    require_matches_scan(tracker, dir.path());
+
+    fs::remove(dir.path() / "two.bin");
+    tracker.poll();
+    REQUIRE(tracker.file_count() == 1);
+    require_matches_scan(tracker, dir.path());
+}
+
+TEST_CASE("Tracker picks up new directories and their files", "[tracker]") {
+    TempDir dir;
+    DataDirTracker tracker;
+    REQUIRE(tracker.start(dir.path().string()) == 0);
+    REQUIRE(wait_measured(tracker));
+
+    fs::create_directories(dir.path() / "torrent" / "sub");
+    write_file(dir.path() / "torrent" / "sub" / "book.epub", 12345);
+    tracker.poll();
+    write_file(dir.path() / "torrent" / "sub" / "book2.epub", 100);
+    tracker.poll();
+    REQUIRE(tracker.file_count() == 2);
+    require_matches_scan(tracker, dir.path());
+
+    fs::remove_all(dir.path() / "torrent");
+    tracker.poll();
+    REQUIRE(tracker.file_count() == 0);
+    REQUIRE(tracker.usage() == 0);
+}
+
+TEST_CASE("Moving a directory out of the tree triggers a rescan", "[tracker]") {
+    TempDir dir;
+    TempDir outside;
+    fs::create_directories(dir.path() / "moved");
+    write_file(dir.path() / "moved" / "f.bin", 7000);
+    write_file(dir.path() / "stays.bin", 3000);
+
+    DataDirTracker tracker;
+    REQUIRE(tracker.start(dir.path().string()) == 0);
+    REQUIRE(wait_measured(tracker));
+    uint64_t before = tracker.usage();
+    fs::rename(dir.path() / "moved", outside.path() / "moved");
+
+    // The rescan runs in the background; the last totals stand meanwhile
+    tracker.poll();
+    REQUIRE(tracker.measuring());
+    REQUIRE(tracker.active());
+    REQUIRE(tracker.usage() == before);
+    REQUIRE(tracker.file_count() == 2);
+
+    REQUIRE(wait_measured(tracker));
+    REQUIRE(tracker.rescans() == 1);
+    REQUIRE(tracker.file_count() == 1);
+    require_matches_scan(tracker, dir.path());
+}
+
+TEST_CASE("Tracker does not start on a missing directory", "[tracker]") {
+    DataDirTracker tracker;
+    REQUIRE(tracker.start("/nonexistent/levin/tracker/root") == -1);
+    REQUIRE_FALSE(tracker.active());
+    REQUIRE_FALSE(tracker.measuring());
+    tracker.poll();  // harmless while inactive
+    REQUIRE(tracker.usage() == 0);
+}
+
+#endif
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+#include "dir_scanner.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace levin;
+
+// --- Test Helpers ---
+
+class TempDir {
+public:
+    TempDir() {
+        path_ = fs::temp_directory_path() / ("levin_scan_test_" + std::to_string(counter_++));
+        fs::remove_all(path_);
+        fs::create_directories(path_);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+    }
+    const fs::path& path() const { return path_; }
+
+private:
+    fs::path path_;
+    static inline int counter_ = 0;
+};
+
+static void create_file(const fs::path& path, size_t size) {
+    fs::create_directories(path.parent_path());
+    std::ofstream f(path, std::ios::binary);
+    std::string data(size, 'x');
+    f.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// --- Tests ---
+
+TEST_CASE("Scan totals nested files and counts non-empty ones", "[scanner]") {
+    TempDir dir;
+    create_file(dir.path() / "a.bin", 8192);
+    create_file(dir.path() / "t1" / "b.bin", 4096);
+    create_file(dir.path() / "t1" / "deep" / "c.bin", 100);
+    create_file(dir.path() / "t2" / "empty.bin", 0);
+
+    DirScan scan = scan_directory(dir.path().string());
+    REQUIRE(scan.file_count == 3);
+    // Allocated blocks, at least the bytes written
+    REQUIRE(scan.usage >= 8192 + 4096 + 100);
+    REQUIRE(scan.files.empty());
+}
+
+TEST_CASE("Collected files carry full paths and sizes", "[scanner]") {
+    TempDir dir;
+    create_file(dir.path() / "top.bin", 10);
+    create_file(dir.path() / "sub" / "inner.bin", 20);
+
+    ScanOptions opts;
+    opts.collect_files = true;
+    DirScan scan = scan_directory(dir.path().string(), opts);
+    REQUIRE(scan.files.size() == 2);
+
+    std::sort(scan.files.begin(), scan.files.end(),
+              [](const ScannedFile& a, const ScannedFile& b) { return a.path < b.path; });
+    REQUIRE(scan.files[0].path == (dir.path() / "sub" / "inner.bin").string());
+    REQUIRE(scan.files[0].size == 20);
+    REQUIRE(scan.files[1].path == (dir.path() / "top.bin").string());
+    REQUIRE(scan.files[1].size == 10);
+
+    uint64_t allocated = scan.files[0].allocated + scan.files[1].allocated;
+    REQUIRE(allocated == scan.usage);
+}
+
+TEST_CASE("Symlinks are neither counted nor followed", "[scanner]") {
+    TempDir dir;
+    TempDir outside;
+    create_file(outside.path() / "big.bin", 65536);
+    create_file(dir.path() / "real.bin", 10);
+    fs::create_symlink(outside.path() / "big.bin", dir.path() / "link.bin");
+    fs::create_directory_symlink(outside.path(), dir.path() / "linkdir");
+
+    ScanOptions opts;
+    opts.collect_files = true;
+    DirScan scan = scan_directory(dir.path().string(), opts);
+    REQUIRE(scan.file_count == 1);
+    REQUIRE(scan.files.size() == 1);
+    REQUIRE(scan.usage < 65536);
+}
+
+TEST_CASE("Top-level breakdown groups files under their torrent", "[scanner]") {
+    TempDir dir;
+    create_file(dir.path() / "single.pdf", 3000);
+    create_file(dir.path() / "multi" / "a.epub", 1000);
+    create_file(dir.path() / "multi" / "sub" / "b.epub", 2000);
+    create_file(dir.path() / "multi" / "empty.txt", 0);
+
+    ScanOptions opts;
+    opts.by_top_level = true;
+    opts.threads = 2;
+    DirScan scan = scan_directory(dir.path().string(), opts);
+    REQUIRE(scan.top_level.size() == 2);
+    REQUIRE(scan.top_level[0].name == "multi");
+    REQUIRE(scan.top_level[0].file_count == 2);
+    REQUIRE(scan.top_level[0].newest_mtime > 0);
+    REQUIRE(scan.top_level[1].name == "single.pdf");
+    REQUIRE(scan.top_level[1].file_count == 1);
+    REQUIRE(scan.top_level[0].usage + scan.top_level[1].usage == scan.usage);
+}
+
+TEST_CASE("Missing root gives an empty result", "[scanner]") {
+    DirScan scan = scan_directory("/nonexistent/levin/scan/root");
+    REQUIRE(scan.usage == 0);
+    REQUIRE(scan.file_count == 0);
+}
+
+TEST_CASE("Parallel and single-threaded scans agree", "[scanner]") {
+    TempDir dir;
+    for (int d = 0; d < 20; d++) {
+        for (int f = 0; f < 25; f++) {
+            create_file(dir.path() / ("d" + std::to_string(d)) / ("sub" + std::to_string(f % 3)) /
+                            ("f" + std::to_string(f)),
+                        static_cast<size_t>(f * 100));
+        }
+    }
+
+    ScanOptions single;
+    single.threads = 1;
+    single.collect_files = true;
+    ScanOptions parallel;
+    parallel.threads = 4;
+    parallel.collect_files = true;
+
+    DirScan a = scan_directory(dir.path().string(), single);
+    DirScan b = scan_directory(dir.path().string(), parallel);
+    REQUIRE(a.files.size() == 500);
+    REQUIRE(b.files.size() == 500);
+    REQUIRE(a.file_count == 480);  // f0 of every directory is empty
+    REQUIRE(b.file_count == a.file_count);
+    REQUIRE(b.usage == a.usage);
+}
@@ -1,9 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
 #include "disk_manager.h"
+#include "dir_scanner.h"
+#include "eviction_index.h"
 
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -97,3 +100,197 @@ TEST_CASE("delete_to_free does not delete more than necessary") {
         if (e.is_regular_file()) remaining++;
     REQUIRE(remaining >= 3);  // deleted at most 2 files (40MB >= 25MB)
 }
+
+TEST_CASE("delete_to_free reports how many files it removed") {
+    TempDir dir;
+    for (int i = 0; i < 4; i++)
+        create_file(dir.path() / ("f" + std::to_string(i)), 10*MB);
+
+    levin::DiskManager dm;
+    int removed = -1;
+    uint64_t freed = dm.delete_to_free(dir, 15*MB, &removed);
+    REQUIRE(removed == 2);
+    REQUIRE(freed >= 20*MB);
+    REQUIRE(dir_size(dir) == 20*MB);
+}
+
+TEST_CASE("delete_to_free evicts the least valuable torrents first") {
+    TempDir dir;
+    fs::create_directories(dir.path() / "popular");
+    fs::create_directories(dir.path() / "stale" / "sub");
+    create_file(dir.path() / "popular" / "a", 10*MB);
+    create_file(dir.path() / "popular" / "b", 10*MB);
+    create_file(dir.path() / "stale" / "a", 10*MB);
+    create_file(dir.path() / "stale" / "sub" / "b", 10*MB);
+    create_file(dir.path() / "single.bin", 10*MB);
+
+    const int64_t now = 1700000000;
+    const int64_t day = 24 * 3600;
+    levin::EvictionIndex index;
+    index.add_demand("popular", 100, now);
+    index.touch("stale", now - 365 * day);
+    index.touch("single.bin", now - 30 * day);
+
+    levin::DiskManager dm;
+    dm.set_eviction_index(&index);
+    int removed = 0;
+    uint64_t freed = dm.delete_to_free(dir, 25*MB, &removed);
+    REQUIRE(freed >= 30*MB);
+    REQUIRE(removed == 3);
+    REQUIRE_FALSE(fs::exists(dir.path() / "stale"));
+    REQUIRE_FALSE(fs::exists(dir.path() / "single.bin"));
+    REQUIRE(dir_size(dir.path() / "popular") == 20*MB);
+    REQUIRE(index.size() == 1);
+    REQUIRE(index.next_victim() == "popular");
+}
+
+TEST_CASE("delete_to_free falls back to random order past the index") {
+    TempDir dir;
+    for (int i = 0; i < 4; i++)
+        create_file(dir.path() / ("f" + std::to_string(i)), 10*MB);
+
+    levin::EvictionIndex index;
+    index.touch("missing", 1700000000);
+
+    levin::DiskManager dm;
+    dm.set_eviction_index(&index);
+    uint64_t freed = dm.delete_to_free(dir, 15*MB);
+    REQUIRE(freed >= 20*MB);
+    REQUIRE(dir_size(dir) == 20*MB);
+    REQUIRE(index.empty());
+}
+
+TEST_CASE("delete_to_free leaves files the evictor takes to it") {
+    TempDir dir;
+    for (int i = 0; i < 4; i++)
+        create_file(dir.path() / ("f" + std::to_string(i)), 10*MB);
+
+    // Takes the even files, as a session would for the torrents it owns
+    std::vector<std::string> taken;
+    levin::DiskManager dm;
+    dm.set_evictor([&taken](const std::vector<std::string>& paths) {
+        std::vector<std::string> rest;
+        for (const auto& p : paths) {
+            char last = p.back();
+            if ((last - '0') % 2 == 0) {
+                taken.push_back(p);
+            } else {
+                rest.push_back(p);
+            }
+        }
+        return rest;
+    });
+
+    int removed = 0;
+    uint64_t freed = dm.delete_to_free(dir, 40*MB, &removed);
+    REQUIRE(freed >= 40*MB);
+    REQUIRE(removed == 4);
+    REQUIRE(taken.size() == 2);
+    for (const auto& p : taken) REQUIRE(fs::exists(p));
+    REQUIRE(dir_size(dir) == 20*MB);
+}
+
+TEST_CASE("delete_to_free stops when the evictor aborts") {
+    TempDir dir;
+    fs::create_directories(dir.path() / "t");
+    for (int i = 0; i < 4; i++)
+        create_file(dir.path() / "t" / ("f" + std::to_string(i)), 10*MB);
+
+    levin::EvictionIndex index;
+    index.touch("t", 1700000000);
+    levin::DiskManager dm;
+    dm.set_eviction_index(&index);
+    dm.set_evictor([](const std::vector<std::string>&) -> std::optional<std::vector<std::string>> {
+        return std::nullopt;
+    });
+
+    int removed = 0;
+    REQUIRE(dm.delete_to_free(dir, 15*MB, &removed) == 0);
+    REQUIRE(removed == 0);
+    REQUIRE(dir_size(dir.path() / "t") == 40*MB);
+    REQUIRE(index.next_victim() == "t");
+}
+
+TEST_CASE("delete_to_free reports what it freed as it goes") {
+    TempDir dir;
+    for (int i = 0; i < 4; i++)
+        create_file(dir.path() / ("f" + std::to_string(i)), 10*MB);
+
+    uint64_t reported = 0;
+    int reported_files = 0;
+    levin::DiskManager dm;
+    dm.set_freed_callback([&](uint64_t bytes, int files) {
+        reported += bytes;
+        reported_files += files;
+    });
+    int removed = 0;
+    uint64_t freed = dm.delete_to_free(dir, 15*MB, &removed);
+    REQUIRE(reported == freed);
+    REQUIRE(reported_files == removed);
+}
+
+TEST_CASE("delete_to_free shrinks a huge file instead of deleting it") {
+    TempDir dir;
+    create_file(dir.path() / "huge.bin", 100*MB);
+    create_file(dir.path() / "small.bin", 1*MB);
+
+    std::vector<std::pair<std::string, uint64_t>> shrunk;
+    levin::DiskManager dm;
+    dm.set_shrinker([&shrunk](const std::string& path, uint64_t bytes) -> uint64_t {
+        shrunk.emplace_back(path, bytes);
+        return bytes;
+    });
+
+    uint64_t freed = dm.delete_to_free(dir, 5*MB);
+    REQUIRE(freed >= 5*MB);
+    REQUIRE(fs::exists(dir.path() / "huge.bin"));
+    // Offered just what was left: all of it, or what small.bin didn't cover
+    REQUIRE(shrunk.size() == 1);
+    REQUIRE(shrunk[0].first == (dir.path() / "huge.bin").string());
+    REQUIRE(shrunk[0].second <= 5*MB);
+    REQUIRE(shrunk[0].second >= 4*MB);
+}
+
+TEST_CASE("delete_to_free deletes a huge file the shrinker passes on") {
+    TempDir dir;
+    create_file(dir.path() / "huge.bin", 100*MB);
+
+    levin::DiskManager dm;
+    dm.set_shrinker([](const std::string&, uint64_t) -> uint64_t { return 0; });
+    uint64_t freed = dm.delete_to_free(dir, 5*MB);
+    REQUIRE(freed >= 100*MB);
+    REQUIRE_FALSE(fs::exists(dir.path() / "huge.bin"));
+}
+
+#ifdef __linux__
+TEST_CASE("punch_hole frees blocks and keeps the file size") {
+    TempDir dir;
+    fs::path path = dir.path() / "big.bin";
+    {
+        std::ofstream f(path, std::ios::binary);
+        std::string chunk(1*MB, 'x');
+        for (int i = 0; i < 8; i++) f.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    }
+    levin::ScannedFile before;
+    REQUIRE(levin::scan_file(path.string(), before));
+
+    REQUIRE(levin::punch_hole(path.string(), 2*MB, 4*MB));
+    levin::ScannedFile after;
+    REQUIRE(levin::scan_file(path.string(), after));
+    REQUIRE(after.size == 8*MB);
+    REQUIRE(after.allocated + 4*MB <= before.allocated);
+
+    std::ifstream f(path, std::ios::binary);
+    f.seekg(3*MB);
+    REQUIRE(f.get() == 0);
+    f.seekg(7*MB);
+    REQUIRE(f.get() == 'x');
+}
+
+TEST_CASE("can_punch_holes leaves nothing behind") {
+    TempDir dir;
+    REQUIRE(levin::can_punch_holes(dir.path().string()));
+    REQUIRE(fs::is_empty(dir.path()));
+    REQUIRE_FALSE(levin::can_punch_holes((dir.path() / "missing").string()));
+}
+#endif
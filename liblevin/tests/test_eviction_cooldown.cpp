@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include "eviction_cooldown.h"
+
+#include <chrono>
+
+using namespace levin;
+using std::chrono::seconds;
+
+constexpr uint64_t MB = 1024ULL * 1024;
+constexpr uint64_t GB = 1024 * MB;
+
+static const EvictionCooldown::TimePoint T0{};
+
+TEST_CASE("Zero window never caps the budget", "[cooldown]") {
+    EvictionCooldown cd(seconds(0));
+    cd.record_eviction(10 * GB, T0);
+    REQUIRE_FALSE(cd.active(T0));
+    REQUIRE(cd.cap_budget(5 * GB, 9 * GB, T0) == 5 * GB);
+}
+
+TEST_CASE("Budget stays below the eviction point for the window", "[cooldown]") {
+    EvictionCooldown cd(seconds(600));
+    cd.record_eviction(10 * GB, T0);
+    REQUIRE(cd.ceiling() == 10 * GB - EvictionCooldown::BASE_MARGIN);
+
+    // Usage right after the eviction: room up to the ceiling only
+    uint64_t usage = 9 * GB;
+    REQUIRE(cd.cap_budget(5 * GB, usage, T0 + seconds(1)) == 1 * GB - EvictionCooldown::BASE_MARGIN);
+    // A smaller budget is left alone
+    REQUIRE(cd.cap_budget(100 * MB, usage, T0 + seconds(1)) == 100 * MB);
+    // Already at the ceiling: nothing
+    REQUIRE(cd.cap_budget(5 * GB, 10 * GB, T0 + seconds(1)) == 0);
+
+    REQUIRE(cd.remaining(T0 + seconds(1)) == seconds(599));
+
+    // Window over: no cap
+    REQUIRE_FALSE(cd.active(T0 + seconds(600)));
+    REQUIRE(cd.cap_budget(5 * GB, usage, T0 + seconds(600)) == 5 * GB);
+}
+
+TEST_CASE("Repeated evictions double window and margin", "[cooldown]") {
+    EvictionCooldown cd(seconds(600));
+    cd.record_eviction(10 * GB, T0);
+    REQUIRE(cd.window() == seconds(600));
+
+    // Evicting again soon after the window ended is churn
+    cd.record_eviction(10 * GB, T0 + seconds(900));
+    REQUIRE(cd.churn_streak() == 1);
+    REQUIRE(cd.window() == seconds(1200));
+    REQUIRE(cd.margin() == 2 * EvictionCooldown::BASE_MARGIN);
+    REQUIRE(cd.active(T0 + seconds(900 + 1199)));
+
+    // Capped at MAX_DOUBLINGS
+    auto t = T0 + seconds(900);
+    for (int i = 0; i < 10; i++) {
+        t += seconds(60);
+        cd.record_eviction(10 * GB, t);
+    }
+    REQUIRE(cd.churn_streak() == EvictionCooldown::MAX_DOUBLINGS);
+    REQUIRE(cd.window() == seconds(600 << EvictionCooldown::MAX_DOUBLINGS));
+}
+
+TEST_CASE("A quiet window resets the cooldown", "[cooldown]") {
+    EvictionCooldown cd(seconds(600));
+    cd.record_eviction(10 * GB, T0);
+    cd.record_eviction(10 * GB, T0 + seconds(300));
+    REQUIRE(cd.churn_streak() == 1);
+
+    // Window of 1200 s ran to T0+1500; quiet for another 1200 s after that
+    cd.record_eviction(8 * GB, T0 + seconds(2700));
+    REQUIRE(cd.churn_streak() == 0);
+    REQUIRE(cd.window() == seconds(600));
+    REQUIRE(cd.ceiling() == 8 * GB - EvictionCooldown::BASE_MARGIN);
+}
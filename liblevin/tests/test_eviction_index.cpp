@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include "eviction_index.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace levin;
+
+static std::string temp_path(const std::string& name) {
+    return (fs::temp_directory_path() / ("levin_eviction_test_" + name)).string();
+}
+
+static const int64_t NOW = 1700000000;
+static const int64_t DAY = 24 * 3600;
+
+TEST_CASE("Empty index has no victim", "[eviction]") {
+    EvictionIndex index;
+    REQUIRE(index.empty());
+    REQUIRE_FALSE(index.next_victim().has_value());
+}
+
+TEST_CASE("Least recently touched entry goes first", "[eviction]") {
+    EvictionIndex index;
+    index.touch("recent", NOW);
+    index.touch("old", NOW - 90 * DAY);
+    index.touch("older", NOW - 365 * DAY);
+    REQUIRE(index.next_victim() == "older");
+
+    index.erase("older");
+    REQUIRE(index.next_victim() == "old");
+    REQUIRE(index.size() == 2);
+}
+
+TEST_CASE("Upload demand keeps an entry", "[eviction]") {
+    EvictionIndex index;
+    index.touch("popular", NOW - 365 * DAY);
+    index.touch("ignored", NOW - DAY);
+    index.add_demand("popular", 50, NOW);
+    REQUIRE(index.next_victim() == "ignored");
+    REQUIRE(index.value("popular", NOW) > index.value("ignored", NOW));
+}
+
+TEST_CASE("Touch leaves known entries alone", "[eviction]") {
+    EvictionIndex index;
+    index.add_demand("a", 10, NOW);
+    double before = index.value("a", NOW);
+    index.touch("a", NOW - 100 * DAY);
+    REQUIRE(index.value("a", NOW) == before);
+}
+
+TEST_CASE("Demand decays with the half-life", "[eviction]") {
+    EvictionIndex index;
+    index.add_demand("a", 8, NOW);
+    double now = index.value("a", NOW);
+    double later = index.value("a", NOW + static_cast<int64_t>(EvictionIndex::HALF_LIFE_SECS));
+    REQUIRE(now - later > 0.999);
+    REQUIRE(now - later < 1.001);
+
+    // Old demand weighs less than the same demand today
+    index.add_demand("b", 8, NOW - 3 * static_cast<int64_t>(EvictionIndex::HALF_LIFE_SECS));
+    REQUIRE(index.next_victim() == "b");
+}
+
+TEST_CASE("Well-seeded entries are cheaper to lose", "[eviction]") {
+    EvictionIndex index;
+    index.add_demand("rare", 10, NOW);
+    index.add_demand("common", 10, NOW);
+    index.set_swarm_seeds("common", 50);
+    REQUIRE(index.next_victim() == "common");
+
+    index.set_swarm_seeds("common", 0);
+    index.set_swarm_seeds("rare", 50);
+    REQUIRE(index.next_victim() == "rare");
+}
+
+TEST_CASE("Sync adds new entries and drops missing ones", "[eviction]") {
+    EvictionIndex index;
+    index.add_demand("kept", 5, NOW);
+    index.add_demand("gone", 5, NOW);
+
+    std::vector<TopLevelUsage> walk;
+    walk.push_back({"kept", 1000, 1, NOW - DAY});
+    walk.push_back({"orphan", 1000, 1, NOW - 200 * DAY});
+    index.sync(walk);
+
+    REQUIRE(index.size() == 2);
+    REQUIRE(index.value("gone", NOW) == -std::numeric_limits<double>::infinity());
+    REQUIRE(index.next_victim() == "orphan");
+}
+
+TEST_CASE("Eviction index round-trips", "[eviction]") {
+    std::string path = temp_path("roundtrip.idx");
+
+    EvictionIndex index;
+    index.add_demand("a", 3, NOW);
+    index.add_demand("b", 30, NOW);
+    index.set_swarm_seeds("b", 7);
+    index.touch("c", NOW - 30 * DAY);
+    REQUIRE(index.save(path));
+
+    EvictionIndex loaded;
+    REQUIRE(loaded.load(path));
+    REQUIRE(loaded.size() == 3);
+    REQUIRE(loaded.next_victim() == index.next_victim());
+    for (const char* name : {"a", "b", "c"}) {
+        REQUIRE(loaded.value(name, NOW) == index.value(name, NOW));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Corrupt eviction index is rejected", "[eviction]") {
+    std::string path = temp_path("corrupt.idx");
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << "LVEV garbage";
+    }
+    EvictionIndex index;
+    index.touch("keep", NOW);
+    REQUIRE_FALSE(index.load(path));
+    REQUIRE(index.size() == 1);
+    REQUIRE_FALSE(index.load(temp_path("missing.idx")));
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+#include "eviction_worker.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace levin;
+
+// Run owner calls until `done` holds, as the tick would
+template <typename Pred>
+static bool pump_until(EvictionWorker& worker, Pred done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        worker.run_owner_calls();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST_CASE("Jobs run inline without a worker", "[eviction_worker]") {
+    EvictionWorker worker;
+    bool ran = false;
+    worker.post([&] {
+        ran = true;
+        worker.add_freed(100, 1);
+        // Already on the owner's thread; the call may post more work
+        REQUIRE(worker.call_on_owner([&] {
+            worker.post([&] { worker.add_freed(1, 0); });
+            return 7;
+        }) == 7);
+    });
+    REQUIRE(ran);
+    REQUIRE_FALSE(worker.busy());
+
+    EvictionWorker::Freed freed = worker.take_freed();
+    REQUIRE(freed.bytes == 101);
+    REQUIRE(freed.files == 1);
+    REQUIRE(worker.take_freed().bytes == 0);
+}
+
+TEST_CASE("Jobs run in order off the caller's thread", "[eviction_worker]") {
+    EvictionWorker worker;
+    worker.start();
+    std::vector<int> order;
+    std::atomic<bool> off_thread{true};
+    auto caller = std::this_thread::get_id();
+    for (int i = 0; i < 5; i++) {
+        worker.post([&, i] {
+            if (std::this_thread::get_id() == caller) off_thread = false;
+            order.push_back(i);
+            worker.add_freed(10, 1);
+        });
+    }
+    REQUIRE(pump_until(worker, [&] { return !worker.busy(); }));
+    worker.stop();
+
+    REQUIRE(off_thread);
+    REQUIRE(order == std::vector<int>{0, 1, 2, 3, 4});
+    EvictionWorker::Freed freed = worker.take_freed();
+    REQUIRE(freed.bytes == 50);
+    REQUIRE(freed.files == 5);
+}
+
+TEST_CASE("Owner calls run on the thread that pumps them", "[eviction_worker]") {
+    EvictionWorker worker;
+    worker.start();
+    auto owner = std::this_thread::get_id();
+    std::atomic<bool> on_owner{false};
+    std::atomic<int> result{0};
+    worker.post([&] {
+        auto r = worker.call_on_owner([&] {
+            on_owner = std::this_thread::get_id() == owner;
+            return 42;
+        });
+        result = r.value_or(-1);
+    });
+
+    // Nothing happens until the owner runs the call
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(worker.busy());
+    REQUIRE(result == 0);
+
+    REQUIRE(pump_until(worker, [&] { return !worker.busy(); }));
+    worker.stop();
+    REQUIRE(on_owner);
+    REQUIRE(result == 42);
+}
+
+TEST_CASE("Stopping declines owner calls and finishes queued jobs", "[eviction_worker]") {
+    EvictionWorker worker;
+    worker.start();
+    std::atomic<bool> waiting{false};
+    std::atomic<bool> declined{false};
+    std::atomic<bool> called{false};
+    std::atomic<bool> second_ran{false};
+    worker.post([&] {
+        waiting = true;
+        auto r = worker.call_on_owner([&] {
+            called = true;
+            return 1;
+        });
+        declined = !r.has_value();
+    });
+    worker.post([&] { second_ran = true; });
+
+    while (!waiting) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    worker.stop();
+    REQUIRE(declined);
+    REQUIRE_FALSE(called);
+    REQUIRE(second_ran);
+    REQUIRE_FALSE(worker.running());
+    REQUIRE_FALSE(worker.busy());
+}
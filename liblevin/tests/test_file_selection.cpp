@@ -0,0 +1,59 @@
+#include <catch2/catch_test_macros.hpp>
+#include "file_selection.h"
+
+using namespace levin;
+
+// --- file_availability ---
+
+TEST_CASE("File availability is the minimum over its pieces", "[selection]") {
+    // piece length 10: file 0 spans pieces 0-1, file 1 spans pieces 2-4
+    std::vector<int64_t> sizes = {20, 30};
+    std::vector<int> pieces = {5, 3, 7, 1, 9};
+    auto avail = file_availability(sizes, 10, pieces);
+    REQUIRE(avail == std::vector<int>{3, 1});
+}
+
+TEST_CASE("Files sharing a boundary piece both see it", "[selection]") {
+    // file 0 covers bytes 0-14 (pieces 0-1), file 1 covers 15-24 (pieces 1-2)
+    std::vector<int64_t> sizes = {15, 10};
+    std::vector<int> pieces = {4, 2, 6};
+    auto avail = file_availability(sizes, 10, pieces);
+    REQUIRE(avail == std::vector<int>{2, 2});
+}
+
+TEST_CASE("Empty files and missing piece data have zero availability", "[selection]") {
+    std::vector<int64_t> sizes = {0, 10, 10};
+    std::vector<int> pieces = {3};  // only the first piece is known
+    auto avail = file_availability(sizes, 10, pieces);
+    REQUIRE(avail == std::vector<int>{0, 3, 0});
+
+    REQUIRE(file_availability(sizes, 0, pieces) == std::vector<int>{0, 0, 0});
+}
+
+// --- rank_rarest_first ---
+
+TEST_CASE("Rarest files rank first", "[selection]") {
+    std::vector<int> avail = {30, 1, 5};
+    auto ranked = rank_rarest_first(avail, {0, 1, 2});
+    REQUIRE(ranked == std::vector<int>{1, 2, 0});
+}
+
+TEST_CASE("Unavailable files rank last", "[selection]") {
+    std::vector<int> avail = {0, 4, 2};
+    auto ranked = rank_rarest_first(avail, {0, 1, 2});
+    REQUIRE(ranked == std::vector<int>{2, 1, 0});
+}
+
+TEST_CASE("Ties keep the base order", "[selection]") {
+    std::vector<int> avail = {2, 2, 2, 1};
+    auto ranked = rank_rarest_first(avail, {2, 0, 3, 1});
+    REQUIRE(ranked == std::vector<int>{3, 2, 0, 1});
+}
+
+// --- swarm_seed_count ---
+
+TEST_CASE("Scrape count is used when known", "[selection]") {
+    REQUIRE(swarm_seed_count(12, 3) == 12);
+    REQUIRE(swarm_seed_count(-1, 3) == 3);
+    REQUIRE(swarm_seed_count(0, 2) == 2);  // stale scrape can't be below what we see
+}
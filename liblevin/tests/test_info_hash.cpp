@@ -0,0 +1,134 @@
+#include <catch2/catch_test_macros.hpp>
+#include "info_hash.h"
+#include "info_hash_map.h"
+
+#include <set>
+#include <string>
+
+using namespace levin;
+
+// --- Test Helpers ---
+
+// v1-sized hash whose table slot is decided by `slot` and that differs
+// from its neighbours by `tag`
+static InfoHash make_hash(uint64_t slot, uint8_t tag) {
+    uint8_t bytes[InfoHash::V1_SIZE] = {};
+    for (int i = 0; i < 8; i++) bytes[i] = static_cast<uint8_t>(slot >> (8 * i));
+    bytes[19] = tag;
+    return InfoHash(bytes, sizeof(bytes));
+}
+
+// --- InfoHash ---
+
+TEST_CASE("Hex round-trips for v1 and v2 hashes", "[infohash]") {
+    std::string v1 = "0123456789abcdef0123456789abcdef01234567";
+    auto h1 = InfoHash::from_hex(v1);
+    REQUIRE(h1.has_value());
+    REQUIRE(h1->size() == InfoHash::V1_SIZE);
+    REQUIRE(h1->to_hex() == v1);
+
+    std::string v2(64, 'f');
+    auto h2 = InfoHash::from_hex(v2);
+    REQUIRE(h2.has_value());
+    REQUIRE(h2->size() == InfoHash::V2_SIZE);
+    REQUIRE(h2->to_hex() == v2);
+
+    char buf[InfoHash::MAX_HEX + 1];
+    h1->to_hex(buf);
+    REQUIRE(std::string(buf) == v1);
+}
+
+TEST_CASE("Uppercase hex is accepted, malformed hex is not", "[infohash]") {
+    auto h = InfoHash::from_hex("0123456789ABCDEF0123456789ABCDEF01234567");
+    REQUIRE(h.has_value());
+    REQUIRE(h->to_hex() == "0123456789abcdef0123456789abcdef01234567");
+
+    REQUIRE_FALSE(InfoHash::from_hex("").has_value());
+    REQUIRE_FALSE(InfoHash::from_hex("0123").has_value());
+    REQUIRE_FALSE(InfoHash::from_hex("0123456789abcdef0123456789abcdef0123456g").has_value());
+}
+
+TEST_CASE("A v1 hash never equals a v2 hash with the same prefix", "[infohash]") {
+    uint8_t bytes[InfoHash::V2_SIZE] = {};
+    InfoHash v1(bytes, InfoHash::V1_SIZE);
+    InfoHash v2(bytes, InfoHash::V2_SIZE);
+    REQUIRE(v1 != v2);
+    REQUIRE(v1 < v2);
+    REQUIRE(InfoHash{}.empty());
+}
+
+// --- InfoHashMap ---
+
+TEST_CASE("Map inserts, finds and overwrites", "[infohash]") {
+    InfoHashMap<int> map;
+    REQUIRE(map.find(make_hash(1, 0)) == map.end());
+
+    map[make_hash(1, 0)] = 10;
+    auto [it, inserted] = map.try_emplace(make_hash(2, 0), 20);
+    REQUIRE(inserted);
+    REQUIRE(it->second == 20);
+    REQUIRE_FALSE(map.try_emplace(make_hash(2, 0), 99).second);
+
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.count(make_hash(1, 0)) == 1);
+    REQUIRE(map.find(make_hash(2, 0))->second == 20);
+    REQUIRE(map.count(make_hash(3, 0)) == 0);
+}
+
+TEST_CASE("Colliding keys stay reachable after erasing from the run", "[infohash]") {
+    InfoHashMap<int> map;
+    // Eight keys probing from the same slot, then one homed just after them
+    for (uint8_t tag = 0; tag < 8; tag++) map[make_hash(5, tag)] = tag;
+    map[make_hash(6, 0)] = 100;
+
+    REQUIRE(map.erase(make_hash(5, 0)) == 1);
+    REQUIRE(map.erase(make_hash(5, 4)) == 1);
+    REQUIRE(map.erase(make_hash(5, 4)) == 0);
+    REQUIRE(map.size() == 7);
+
+    for (uint8_t tag = 0; tag < 8; tag++) {
+        bool expected = tag != 0 && tag != 4;
+        REQUIRE(map.count(make_hash(5, tag)) == (expected ? 1u : 0u));
+    }
+    REQUIRE(map.find(make_hash(6, 0))->second == 100);
+}
+
+TEST_CASE("Probe runs wrap around the end of the table", "[infohash]") {
+    InfoHashMap<int> map;
+    map.reserve(8);
+    size_t last = map.capacity() - 1;
+    for (uint8_t tag = 0; tag < 4; tag++) map[make_hash(last, tag)] = tag;
+    map[make_hash(0, 9)] = 9;
+
+    REQUIRE(map.erase(make_hash(last, 1)) == 1);
+    for (uint8_t tag = 0; tag < 4; tag++) {
+        REQUIRE(map.count(make_hash(last, tag)) == (tag == 1 ? 0u : 1u));
+    }
+    REQUIRE(map.find(make_hash(0, 9))->second == 9);
+}
+
+TEST_CASE("Map grows and iterates every entry once", "[infohash]") {
+    InfoHashMap<int> map;
+    const int n = 10000;
+    for (int i = 0; i < n; i++) {
+        map[make_hash(static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL, 0)] = i;
+    }
+    REQUIRE(map.size() == static_cast<size_t>(n));
+    REQUIRE(map.capacity() * 3 >= map.size() * 4);
+
+    std::set<int> seen;
+    for (const auto& [key, value] : map) seen.insert(value);
+    REQUIRE(seen.size() == static_cast<size_t>(n));
+
+    for (int i = 0; i < n; i += 2) {
+        map.erase(make_hash(static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL, 0));
+    }
+    REQUIRE(map.size() == static_cast<size_t>(n / 2));
+    for (int i = 1; i < n; i += 2) {
+        REQUIRE(map.find(make_hash(static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL, 0))->second == i);
+    }
+
+    map.clear();
+    REQUIRE(map.empty());
+    REQUIRE(map.begin() == map.end());
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+#include "io_profile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#endif
+
+namespace fs = std::filesystem;
+using namespace levin;
+
+// --- Test Helpers ---
+
+class TempDir {
+public:
+    TempDir() {
+        path_ = fs::temp_directory_path() / ("levin_io_test_" + std::to_string(counter_++));
+        fs::create_directories(path_);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+    }
+    const fs::path& path() const { return path_; }
+
+private:
+    fs::path path_;
+    static inline int counter_ = 0;
+};
+
+#if defined(__linux__)
+// Build a fake sysfs under root where the device holding `data` is
+// <disk>/<partition> (or <disk> itself if partition is empty)
+static void fake_sysfs(const fs::path& root, const fs::path& data,
+                       const std::string& disk, const std::string& partition, int rotational) {
+    struct stat st;
+    REQUIRE(::stat(data.c_str(), &st) == 0);
+    std::string dev_id = std::to_string(major(st.st_dev)) + ":" + std::to_string(minor(st.st_dev));
+
+    fs::path disk_dir = root / "devices" / "virtual" / disk;
+    fs::create_directories(disk_dir / "queue");
+    std::ofstream(disk_dir / "queue" / "rotational") << rotational << "\n";
+
+    fs::path target = partition.empty() ? disk_dir : disk_dir / partition;
+    fs::create_directories(target);
+    fs::create_directories(root / "dev" / "block");
+    fs::create_directory_symlink(target, root / "dev" / "block" / dev_id);
+}
+#endif
+
+// --- Tests ---
+
+TEST_CASE("Profiles scale disk parallelism with the device", "[io]") {
+    auto sd = io_settings_for(IoProfile::SD);
+    auto hdd = io_settings_for(IoProfile::HDD);
+    auto ssd = io_settings_for(IoProfile::SSD);
+    auto nvme = io_settings_for(IoProfile::NVME);
+
+    REQUIRE(sd.write_mode == DiskWriteMode::WRITE_THROUGH);
+    REQUIRE(hdd.write_mode == DiskWriteMode::OS_CACHE);
+    REQUIRE(sd.max_queued_disk_bytes < hdd.max_queued_disk_bytes);
+    REQUIRE(hdd.aio_threads < ssd.aio_threads);
+    REQUIRE(ssd.aio_threads < nvme.aio_threads);
+    REQUIRE(ssd.send_buffer_watermark < nvme.send_buffer_watermark);
+}
+
+TEST_CASE("AUTO settings match SSD", "[io]") {
+    auto a = io_settings_for(IoProfile::AUTO);
+    auto s = io_settings_for(IoProfile::SSD);
+    REQUIRE(a.aio_threads == s.aio_threads);
+    REQUIRE(a.max_queued_disk_bytes == s.max_queued_disk_bytes);
+}
+
+TEST_CASE("Profile names round-trip", "[io]") {
+    for (auto p : {IoProfile::AUTO, IoProfile::SD, IoProfile::SSD, IoProfile::HDD, IoProfile::NVME}) {
+        REQUIRE(parse_io_profile(io_profile_name(p)) == p);
+    }
+    REQUIRE(parse_io_profile("floppy") == IoProfile::AUTO);
+}
+
+#if defined(__linux__)
+TEST_CASE("Rotational partition is detected as HDD", "[io]") {
+    TempDir tmp;
+    fake_sysfs(tmp.path() / "sys", tmp.path(), "sda", "sda1", 1);
+    REQUIRE(detect_io_profile(tmp.path().string(), (tmp.path() / "sys").string()) == IoProfile::HDD);
+}
+
+TEST_CASE("Non-rotational disk is detected as SSD", "[io]") {
+    TempDir tmp;
+    fake_sysfs(tmp.path() / "sys", tmp.path(), "sdb", "", 0);
+    REQUIRE(detect_io_profile(tmp.path().string(), (tmp.path() / "sys").string()) == IoProfile::SSD);
+}
+
+TEST_CASE("Device names identify SD cards and NVMe", "[io]") {
+    TempDir sd;
+    fake_sysfs(sd.path() / "sys", sd.path(), "mmcblk0", "mmcblk0p2", 0);
+    REQUIRE(detect_io_profile(sd.path().string(), (sd.path() / "sys").string()) == IoProfile::SD);
+
+    TempDir nvme;
+    fake_sysfs(nvme.path() / "sys", nvme.path(), "nvme0n1", "nvme0n1p1", 0);
+    REQUIRE(detect_io_profile(nvme.path().string(), (nvme.path() / "sys").string()) == IoProfile::NVME);
+}
+
+TEST_CASE("Unknown device falls back to SSD", "[io]") {
+    TempDir tmp;
+    fs::create_directories(tmp.path() / "sys");
+    REQUIRE(detect_io_profile(tmp.path().string(), (tmp.path() / "sys").string()) == IoProfile::SSD);
+}
+#endif
@@ -0,0 +1,64 @@
+#include <catch2/catch_test_macros.hpp>
+#include "memory_budget.h"
+
+using namespace levin;
+
+constexpr uint64_t MB = 1024ULL * 1024;
+
+TEST_CASE("No budget keeps libtorrent defaults and profile I/O values", "[memory]") {
+    auto io = io_settings_for(IoProfile::SSD);
+    auto s = derive_memory_settings(0, 1000, 56, io);
+    REQUIRE(s.connections_limit == 200);
+    REQUIRE(s.max_peerlist_size == 3000);
+    REQUIRE(s.max_queued_disk_bytes == io.max_queued_disk_bytes);
+    REQUIRE(s.send_buffer_watermark == io.send_buffer_watermark);
+}
+
+TEST_CASE("Smaller budget gives smaller limits", "[memory]") {
+    auto io = io_settings_for(IoProfile::SSD);
+    auto big = derive_memory_settings(1024 * MB, 500, 56, io);
+    auto small = derive_memory_settings(64 * MB, 500, 56, io);
+    REQUIRE(small.connections_limit < big.connections_limit);
+    REQUIRE(small.max_paused_peerlist_size <= big.max_paused_peerlist_size);
+    REQUIRE(small.send_buffer_watermark <= big.send_buffer_watermark);
+}
+
+TEST_CASE("More torrents shrink per-torrent peer lists", "[memory]") {
+    auto io = io_settings_for(IoProfile::SSD);
+    auto few = derive_memory_settings(256 * MB, 100, 56, io);
+    auto many = derive_memory_settings(256 * MB, 2000, 56, io);
+    REQUIRE(many.max_paused_peerlist_size < few.max_paused_peerlist_size);
+}
+
+TEST_CASE("Profile I/O values are an upper bound", "[memory]") {
+    auto io = io_settings_for(IoProfile::SD);
+    auto s = derive_memory_settings(64ULL * 1024 * MB, 10, 10, io);
+    REQUIRE(s.max_queued_disk_bytes <= io.max_queued_disk_bytes);
+    REQUIRE(s.send_buffer_watermark <= io.send_buffer_watermark);
+    REQUIRE(s.send_buffer_low_watermark <= io.send_buffer_low_watermark);
+}
+
+TEST_CASE("Budget too small for the load falls back to minimums", "[memory]") {
+    auto s = derive_memory_settings(1 * MB, 5000, 56, io_settings_for(IoProfile::HDD));
+    REQUIRE(s.connections_limit == 10);
+    REQUIRE(s.max_peerlist_size == 50);
+    REQUIRE(s.max_paused_peerlist_size == 10);
+}
+
+TEST_CASE("Derived settings keep the estimate inside the budget", "[memory]") {
+    auto io = io_settings_for(IoProfile::SSD);
+    uint64_t budget = 512 * MB;
+    auto s = derive_memory_settings(budget, 1000, 56, io);
+    uint64_t est = estimate_memory_usage(1000, s.connections_limit,
+                                         static_cast<uint64_t>(s.max_queued_disk_bytes), s);
+    REQUIRE(est <= budget);
+}
+
+TEST_CASE("Estimate grows with load", "[memory]") {
+    auto s = derive_memory_settings(0, 0, 0, io_settings_for(IoProfile::SSD));
+    uint64_t idle = estimate_memory_usage(0, 0, 0, s);
+    REQUIRE(idle == MemoryCosts::BASE);
+    REQUIRE(estimate_memory_usage(10, 0, 0, s) > idle);
+    REQUIRE(estimate_memory_usage(0, 10, 0, s) > idle);
+    REQUIRE(estimate_memory_usage(0, 0, MB, s) == idle + MB);
+}
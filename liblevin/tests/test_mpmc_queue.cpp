@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+#include "mpmc_queue.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using levin::MpmcQueue;
+
+TEST_CASE("Capacity rounds up to a power of two", "[mpmc]") {
+    MpmcQueue<int> q(5);
+    REQUIRE(q.capacity() == 8);
+}
+
+TEST_CASE("Push and pop preserve FIFO order", "[mpmc]") {
+    MpmcQueue<std::string> q(4);
+    REQUIRE(q.try_push("a"));
+    REQUIRE(q.try_push("b"));
+
+    std::string out;
+    REQUIRE(q.try_pop(out));
+    REQUIRE(out == "a");
+    REQUIRE(q.try_pop(out));
+    REQUIRE(out == "b");
+    REQUIRE(!q.try_pop(out));
+}
+
+TEST_CASE("Push fails when full and leaves the value intact", "[mpmc]") {
+    MpmcQueue<std::string> q(2);
+    REQUIRE(q.try_push("x"));
+    REQUIRE(q.try_push("y"));
+
+    std::string v = "z";
+    REQUIRE(!q.try_push(std::move(v)));
+    REQUIRE(v == "z");
+
+    std::string out;
+    REQUIRE(q.try_pop(out));
+    REQUIRE(q.try_push(std::move(v)));
+}
+
+TEST_CASE("Concurrent producers deliver every item exactly once", "[mpmc]") {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 10000;
+    MpmcQueue<int> q(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&q, p] {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                int v = p * PER_PRODUCER + i;
+                while (!q.try_push(std::move(v))) std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<int> seen(PRODUCERS * PER_PRODUCER, 0);
+    int received = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        int v;
+        if (q.try_pop(v)) {
+            seen[v]++;
+            received++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : producers) t.join();
+
+    for (int count : seen) REQUIRE(count == 1);
+}
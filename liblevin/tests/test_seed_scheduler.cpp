@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include "seed_scheduler.h"
+
+using namespace levin;
+
+static SeedCandidate seed(double upload, int leechers, int seeds, bool active, int64_t idle = 0) {
+    SeedCandidate c;
+    c.upload_rate = upload;
+    c.leechers = leechers;
+    c.seeds = seeds;
+    c.active = active;
+    c.idle_secs = idle;
+    return c;
+}
+
+static int count_chosen(const std::vector<bool>& chosen) {
+    int n = 0;
+    for (bool b : chosen) n += b ? 1 : 0;
+    return n;
+}
+
+// --- seed_demand_score ---
+
+TEST_CASE("Leechers with few seeds raise demand", "[seeding]") {
+    REQUIRE(seed_demand_score(seed(0, 10, 0, true)) > seed_demand_score(seed(0, 10, 30, true)));
+    REQUIRE(seed_demand_score(seed(0, 0, 0, true)) == 0);
+}
+
+TEST_CASE("Measured upload raises demand", "[seeding]") {
+    REQUIRE(seed_demand_score(seed(50000, 1, 1, true)) > seed_demand_score(seed(0, 1, 1, true)));
+}
+
+// --- choose_active_seeds ---
+
+TEST_CASE("Everything is active when there are enough slots", "[seeding]") {
+    std::vector<SeedCandidate> c = {seed(0, 0, 0, false), seed(0, 0, 0, false)};
+    auto chosen = choose_active_seeds(c, 5, 1);
+    REQUIRE(chosen == std::vector<bool>{true, true});
+}
+
+TEST_CASE("Highest demand wins the slots", "[seeding]") {
+    std::vector<SeedCandidate> c = {
+        seed(100, 0, 5, true),
+        seed(90000, 3, 1, true),
+        seed(0, 8, 0, false),
+        seed(0, 0, 20, false),
+    };
+    auto chosen = choose_active_seeds(c, 2, 0);
+    REQUIRE(chosen == std::vector<bool>{false, true, true, false});
+}
+
+TEST_CASE("Probe slots go to the longest idle torrents", "[seeding]") {
+    std::vector<SeedCandidate> c = {
+        seed(90000, 5, 1, true),
+        seed(80000, 5, 1, true),
+        seed(0, 0, 0, false, 600),
+        seed(0, 0, 0, false, 7200),
+    };
+    auto chosen = choose_active_seeds(c, 2, 1);
+    REQUIRE(count_chosen(chosen) == 2);
+    REQUIRE(chosen[3]);   // idle longest
+    REQUIRE(chosen[0]);   // highest demand
+    REQUIRE(!chosen[2]);
+}
+
+TEST_CASE("Incumbents keep their slot on equal demand", "[seeding]") {
+    std::vector<SeedCandidate> c = {
+        seed(0, 2, 2, false),
+        seed(0, 2, 2, true),
+    };
+    auto chosen = choose_active_seeds(c, 1, 0);
+    REQUIRE(chosen == std::vector<bool>{false, true});
+}
+
+TEST_CASE("No slots means nothing is active", "[seeding]") {
+    std::vector<SeedCandidate> c = {seed(1000, 1, 1, true)};
+    REQUIRE(choose_active_seeds(c, 0, 0) == std::vector<bool>{false});
+}
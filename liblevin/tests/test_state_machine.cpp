@@ -134,3 +134,112 @@ TEST_CASE("Removing all torrents goes to IDLE even if storage ok") {
     sm.update_has_torrents(false);
     REQUIRE(sm.state() == State::IDLE);
 }
+
+// --- Debounce and dwell ---
+
+// Manually advanced time source
+struct FakeClock {
+    std::chrono::steady_clock::time_point now{std::chrono::hours(1)};
+    StateClock source() { return [this] { return now; }; }
+    void advance(int secs) { now += std::chrono::seconds(secs); }
+};
+
+static void bring_up(StateMachine& sm) {
+    sm.update_enabled(true);
+    sm.update_battery(true);
+    sm.update_network(true);
+    sm.update_has_torrents(true);
+    sm.update_storage(true);
+}
+
+TEST_CASE("Condition flapping inside the debounce window is suppressed") {
+    FakeClock clock;
+    StateMachine sm(clock.source());
+    sm.set_debounce(Condition::BATTERY, std::chrono::seconds(5));
+    bring_up(sm);
+    REQUIRE(sm.state() == State::DOWNLOADING);
+
+    int count = 0;
+    sm.set_callback([&](State, State) { count++; });
+    for (int i = 0; i < 3; i++) {
+        sm.update_battery(false);
+        clock.advance(2);
+        sm.tick();
+        sm.update_battery(true);
+        clock.advance(2);
+        sm.tick();
+    }
+    REQUIRE(count == 0);
+    REQUIRE(sm.state() == State::DOWNLOADING);
+    REQUIRE(sm.suppressed_transitions() == 3);
+}
+
+TEST_CASE("A change that holds takes effect once the window passes") {
+    FakeClock clock;
+    StateMachine sm(clock.source());
+    sm.set_debounce(Condition::NETWORK, std::chrono::seconds(5));
+    bring_up(sm);
+
+    sm.update_network(false);
+    REQUIRE(sm.state() == State::DOWNLOADING);
+    clock.advance(4);
+    sm.tick();
+    REQUIRE(sm.state() == State::DOWNLOADING);
+    clock.advance(1);
+    sm.tick();
+    REQUIRE(sm.state() == State::PAUSED);
+    REQUIRE(sm.suppressed_transitions() == 0);
+}
+
+TEST_CASE("Moving back up waits for the dwell time, moving down does not") {
+    FakeClock clock;
+    StateMachine sm(clock.source());
+    sm.set_min_dwell(State::PAUSED, std::chrono::seconds(30));
+    bring_up(sm);
+
+    sm.update_battery(false);
+    REQUIRE(sm.state() == State::PAUSED);
+
+    sm.update_battery(true);
+    REQUIRE(sm.state() == State::PAUSED);
+    clock.advance(29);
+    sm.tick();
+    REQUIRE(sm.state() == State::PAUSED);
+    clock.advance(1);
+    sm.tick();
+    REQUIRE(sm.state() == State::DOWNLOADING);
+
+    // Disabling is a move down, so it's never held back
+    sm.update_enabled(false);
+    REQUIRE(sm.state() == State::OFF);
+}
+
+TEST_CASE("A deferred move up that reverts counts as suppressed") {
+    FakeClock clock;
+    StateMachine sm(clock.source());
+    sm.set_min_dwell(State::PAUSED, std::chrono::seconds(30));
+    bring_up(sm);
+    sm.update_battery(false);
+
+    int count = 0;
+    sm.set_callback([&](State, State) { count++; });
+    sm.update_battery(true);
+    clock.advance(10);
+    sm.update_battery(false);
+    clock.advance(60);
+    sm.tick();
+
+    REQUIRE(count == 0);
+    REQUIRE(sm.state() == State::PAUSED);
+    REQUIRE(sm.suppressed_transitions() == 1);
+}
+
+TEST_CASE("Start-up is not held back by dwell times") {
+    FakeClock clock;
+    StateMachine sm(clock.source());
+    for (auto s : {State::OFF, State::PAUSED, State::IDLE, State::SEEDING}) {
+        sm.set_min_dwell(s, std::chrono::seconds(30));
+    }
+    bring_up(sm);
+    REQUIRE(sm.state() == State::DOWNLOADING);
+}
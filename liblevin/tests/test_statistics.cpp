@@ -62,6 +62,25 @@ TEST_CASE("Statistics update computes cumulative totals", "[statistics]") {
     CHECK(stats.session_uploaded == 300);
 }
 
+TEST_CASE("Statistics totals never go backwards", "[statistics]") {
+    levin::Statistics stats;
+    stats.update(1000, 2000, 500, 300);
+    CHECK(stats.total_downloaded == 1500);
+    CHECK(stats.total_uploaded == 2300);
+
+    // Session counters shrinking (e.g. summed over fewer torrents) must not
+    // reduce the persisted totals
+    stats.update(1000, 2000, 100, 50);
+    CHECK(stats.total_downloaded == 1500);
+    CHECK(stats.total_uploaded == 2300);
+    CHECK(stats.session_downloaded == 100);
+    CHECK(stats.session_uploaded == 50);
+
+    stats.update(1000, 2000, 800, 400);
+    CHECK(stats.total_downloaded == 1800);
+    CHECK(stats.total_uploaded == 2400);
+}
+
 TEST_CASE("Statistics persist across simulated restarts", "[statistics]") {
     auto tmp = fs::temp_directory_path() / "levin_test_stats_restart";
     fs::create_directories(tmp);
@@ -103,3 +122,39 @@ TEST_CASE("Statistics persist across simulated restarts", "[statistics]") {
 
     fs::remove_all(tmp);
 }
+
+TEST_CASE("Statistics keep wasted bytes and read version 1 files", "[statistics]") {
+    auto tmp = fs::temp_directory_path() / "levin_test_stats_wasted";
+    fs::create_directories(tmp);
+    std::string path = (tmp / "stats.dat").string();
+
+    levin::Statistics stats;
+    stats.total_downloaded = 1000;
+    stats.update_wasted(100, 50);
+    stats.update_wasted(100, 20);  // never goes backwards
+    CHECK(stats.total_wasted == 150);
+    REQUIRE(stats.save(path));
+
+    levin::Statistics loaded;
+    REQUIRE(loaded.load(path));
+    CHECK(loaded.total_downloaded == 1000);
+    CHECK(loaded.total_wasted == 150);
+
+    // A file from before wasted bytes were counted
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        uint32_t ver = 1;
+        uint64_t down = 7, up = 9;
+        f.write("LVST", 4);
+        f.write(reinterpret_cast<const char*>(&ver), 4);
+        f.write(reinterpret_cast<const char*>(&down), 8);
+        f.write(reinterpret_cast<const char*>(&up), 8);
+    }
+    levin::Statistics old;
+    REQUIRE(old.load(path));
+    CHECK(old.total_downloaded == 7);
+    CHECK(old.total_uploaded == 9);
+    CHECK(old.total_wasted == 0);
+
+    fs::remove_all(tmp);
+}
@@ -0,0 +1,187 @@
+#include <catch2/catch_test_macros.hpp>
+#include "torrent_index.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using levin::InfoHash;
+using levin::TorrentIndex;
+using levin::TorrentMetadata;
+
+// --- Test Helpers ---
+
+class TempDir {
+public:
+    TempDir() {
+        path_ = fs::temp_directory_path() / ("levin_index_test_" + std::to_string(counter_++));
+        fs::create_directories(path_);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+    }
+    const fs::path& path() const { return path_; }
+
+private:
+    fs::path path_;
+    static inline int counter_ = 0;
+};
+
+static void write_file(const fs::path& path, const std::string& content) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f << content;
+}
+
+static TorrentMetadata make_meta(const std::string& name) {
+    TorrentMetadata meta;
+    meta.info_hash = *InfoHash::from_hex("0123456789abcdef0123456789abcdef01234567");
+    meta.name = name;
+    meta.total_size = 300;
+    meta.piece_length = 16384;
+    meta.file_sizes = {100, 200};
+    return meta;
+}
+
+// --- Tests ---
+
+TEST_CASE("Missing index file opens as empty", "[index]") {
+    TempDir tmp;
+    TorrentIndex index;
+    REQUIRE(index.open((tmp.path() / "torrents.idx").string()));
+    REQUIRE(index.size() == 0);
+}
+
+TEST_CASE("Entries survive save and reopen", "[index]") {
+    TempDir tmp;
+    auto torrent = (tmp.path() / "a.torrent").string();
+    auto idx_path = (tmp.path() / "torrents.idx").string();
+    write_file(torrent, "d4:infod4:name1:aee");
+
+    {
+        TorrentIndex index;
+        REQUIRE(index.open(idx_path));
+        index.put(torrent, make_meta("Book A"));
+        REQUIRE(index.save());
+    }
+
+    TorrentIndex index;
+    REQUIRE(index.open(idx_path));
+    REQUIRE(index.size() == 1);
+
+    auto meta = index.find(torrent);
+    REQUIRE(meta.has_value());
+    REQUIRE(meta->name == "Book A");
+    REQUIRE(meta->info_hash.to_hex() == "0123456789abcdef0123456789abcdef01234567");
+    REQUIRE(meta->total_size == 300);
+    REQUIRE(meta->file_count == 2);
+    REQUIRE(meta->piece_length == 16384);
+    REQUIRE(meta->file_sizes.empty());
+
+    auto full = index.find(torrent, true);
+    REQUIRE(full.has_value());
+    REQUIRE(full->file_sizes == std::vector<uint64_t>{100, 200});
+}
+
+TEST_CASE("Changed .torrent file invalidates its entry", "[index]") {
+    TempDir tmp;
+    auto torrent = (tmp.path() / "a.torrent").string();
+    write_file(torrent, "d4:infod4:name1:aee");
+
+    TorrentIndex index;
+    REQUIRE(index.open((tmp.path() / "torrents.idx").string()));
+    index.put(torrent, make_meta("Book A"));
+    REQUIRE(index.find(torrent).has_value());
+
+    write_file(torrent, "d4:infod4:name2:abee");
+    REQUIRE(!index.find(torrent).has_value());
+}
+
+TEST_CASE("retain_only drops entries for removed torrents", "[index]") {
+    TempDir tmp;
+    auto a = (tmp.path() / "a.torrent").string();
+    auto b = (tmp.path() / "b.torrent").string();
+    auto idx_path = (tmp.path() / "torrents.idx").string();
+    write_file(a, "a");
+    write_file(b, "b");
+
+    TorrentIndex index;
+    REQUIRE(index.open(idx_path));
+    index.put(a, make_meta("A"));
+    index.put(b, make_meta("B"));
+    REQUIRE(index.save());
+
+    index.retain_only({a});
+    REQUIRE(index.size() == 1);
+    REQUIRE(index.save());
+
+    TorrentIndex reopened;
+    REQUIRE(reopened.open(idx_path));
+    REQUIRE(reopened.size() == 1);
+    REQUIRE(reopened.find(a).has_value());
+    REQUIRE(!reopened.find(b).has_value());
+}
+
+TEST_CASE("Failed save keeps the index usable", "[index]") {
+    TempDir tmp;
+    auto a = (tmp.path() / "a.torrent").string();
+    auto b = (tmp.path() / "b.torrent").string();
+    auto idx_path = (tmp.path() / "torrents.idx").string();
+    write_file(a, "a");
+    write_file(b, "b");
+
+    TorrentIndex index;
+    REQUIRE(index.open(idx_path));
+    index.put(a, make_meta("A"));
+    REQUIRE(index.save());
+    index.put(b, make_meta("B"));
+
+    // A non-empty directory where the index was: the rename can't replace it
+    fs::remove(idx_path);
+    fs::create_directories(fs::path(idx_path) / "blocker");
+
+    REQUIRE_FALSE(index.save());
+    REQUIRE(!fs::exists(idx_path + ".tmp"));
+    REQUIRE(index.size() == 2);
+    auto meta = index.find(a);
+    REQUIRE(meta.has_value());
+    REQUIRE(meta->name == "A");
+    REQUIRE(index.find(b).has_value());
+}
+
+TEST_CASE("Corrupt index file is discarded", "[index]") {
+    TempDir tmp;
+    auto idx_path = (tmp.path() / "torrents.idx").string();
+    write_file(idx_path, "not an index");
+
+    TorrentIndex index;
+    REQUIRE(index.open(idx_path));
+    REQUIRE(index.size() == 0);
+}
+
+TEST_CASE("Record too short for its contents is discarded", "[index]") {
+    TempDir tmp;
+    auto torrent = (tmp.path() / "a.torrent").string();
+    auto idx_path = (tmp.path() / "torrents.idx").string();
+    write_file(torrent, "d4:infod4:name1:aee");
+    {
+        TorrentIndex index;
+        REQUIRE(index.open(idx_path));
+        index.put(torrent, make_meta("Book A"));
+        REQUIRE(index.save());
+    }
+
+    // Shrink the first record's length to its fixed header alone; the path,
+    // name and file sizes it claims would then lie past it
+    {
+        std::fstream f(idx_path, std::ios::binary | std::ios::in | std::ios::out);
+        uint32_t record_len = 80;
+        f.seekp(16);
+        f.write(reinterpret_cast<const char*>(&record_len), sizeof(record_len));
+    }
+
+    TorrentIndex index;
+    REQUIRE(index.open(idx_path));
+    REQUIRE(index.size() == 0);
+}
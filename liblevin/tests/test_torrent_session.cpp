@@ -5,8 +5,10 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include "torrent_session.h"
+#include <chrono>
 #include <filesystem>
 #include <string>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -81,7 +83,110 @@ TEST_CASE("Added torrent has WebSocket trackers") {
     fs::remove_all(tmp_dir, ec);
 }
 
-TEST_CASE("pause_downloads sets rate limit to 1") {
+TEST_CASE("Torrent list is served from the status cache") {
+    auto session = levin::create_real_torrent_session();
+    session->configure(16886, "stun.l.google.com:19302");
+
+    std::string tmp_dir = (fs::temp_directory_path() / "levin_cache_test").string();
+    fs::create_directories(tmp_dir);
+
+    session->start(tmp_dir);
+
+    auto torrent_path = find_test_torrent();
+    REQUIRE(fs::exists(torrent_path));
+
+    auto hash = session->add_torrent(torrent_path);
+    REQUIRE(hash.has_value());
+
+    // Listed immediately after add, before any state update arrives
+    auto list = session->get_torrent_list();
+    REQUIRE(list.size() == 1);
+    REQUIRE(list[0].info_hash == *hash);
+    REQUIRE(!list[0].name.empty());
+
+    session->process_alerts();
+    session->process_alerts();
+    REQUIRE(session->get_torrent_list().size() == 1);
+    REQUIRE(session->peer_count() >= 0);
+
+    session->remove_torrent(*hash);
+    REQUIRE(session->get_torrent_list().empty());
+    session->stop();
+
+    std::error_code ec;
+    fs::remove_all(tmp_dir, ec);
+}
+
+TEST_CASE("Resume data is written on stop and reused on restart") {
+    std::string tmp_dir = (fs::temp_directory_path() / "levin_resume_test").string();
+    std::string resume_dir = tmp_dir + "/resume";
+    fs::create_directories(tmp_dir);
+
+    auto torrent_path = find_test_torrent();
+    REQUIRE(fs::exists(torrent_path));
+
+    levin::InfoHash hash;
+    {
+        auto session = levin::create_real_torrent_session();
+        session->configure(16887, "stun.l.google.com:19302");
+        session->set_resume_directory(resume_dir);
+        session->start(tmp_dir);
+        auto added = session->add_torrent(torrent_path);
+        REQUIRE(added.has_value());
+        hash = *added;
+        session->stop();
+    }
+    REQUIRE(fs::exists(resume_dir + "/" + hash.to_hex() + ".resume"));
+
+    {
+        auto session = levin::create_real_torrent_session();
+        session->configure(16887, "stun.l.google.com:19302");
+        session->set_resume_directory(resume_dir);
+        session->start(tmp_dir);
+        auto added = session->add_torrent(torrent_path);
+        REQUIRE(added.has_value());
+        REQUIRE(*added == hash);
+
+        // Trackers survive the round trip without being injected twice
+        auto trackers = session->get_trackers(hash);
+        int wss = 0;
+        for (auto& t : trackers) {
+            if (t == "wss://tracker.openwebtorrent.com") wss++;
+        }
+        REQUIRE(wss == 1);
+        session->stop();
+    }
+
+    std::error_code ec;
+    fs::remove_all(tmp_dir, ec);
+}
+
+TEST_CASE("async_add_torrent parses off-thread and registers on a later tick") {
+    auto session = levin::create_real_torrent_session();
+    session->configure(16888, "stun.l.google.com:19302");
+
+    std::string tmp_dir = (fs::temp_directory_path() / "levin_async_add_test").string();
+    fs::create_directories(tmp_dir);
+
+    session->start(tmp_dir);
+
+    auto torrent_path = find_test_torrent();
+    REQUIRE(fs::exists(torrent_path));
+    REQUIRE(session->async_add_torrent(torrent_path));
+
+    for (int i = 0; i < 100 && session->torrent_count() == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        session->process_alerts();
+    }
+    REQUIRE(session->torrent_count() == 1);
+    REQUIRE(session->pending_adds() == 0);
+    session->stop();
+
+    std::error_code ec;
+    fs::remove_all(tmp_dir, ec);
+}
+
+TEST_CASE("pause_downloads enters seed-only mode without touching the rate limit") {
     auto session = levin::create_real_torrent_session();
     session->configure(16884, "stun.l.google.com:19302");
 
@@ -89,10 +194,13 @@ TEST_CASE("pause_downloads sets rate limit to 1") {
     fs::create_directories(tmp_dir);
 
     session->start(tmp_dir);
+    session->set_download_rate_limit(50 * 1024);
     session->pause_downloads();
-    REQUIRE(session->get_download_rate_limit() == 1);
+    REQUIRE(session->downloads_paused());
+    REQUIRE(session->get_download_rate_limit() == 50 * 1024);
     session->resume_downloads();
-    REQUIRE(session->get_download_rate_limit() == 0);
+    REQUIRE_FALSE(session->downloads_paused());
+    REQUIRE(session->get_download_rate_limit() == 50 * 1024);
     session->stop();
 
     std::error_code ec;
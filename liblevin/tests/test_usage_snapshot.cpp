@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+#include "usage_snapshot.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace levin;
+
+static std::string temp_path(const std::string& name) {
+    return (fs::temp_directory_path() / ("levin_usage_test_" + name)).string();
+}
+
+TEST_CASE("Usage snapshot round-trips", "[snapshot]") {
+    std::string path = temp_path("roundtrip.snap");
+
+    UsageSnapshot snap;
+    snap.data_directory = "/data/levin";
+    snap.usage = 123456789;
+    snap.file_count = 42;
+    snap.entries.push_back({"Some Torrent", 100000000, 40, 1700000000});
+    snap.entries.push_back({"single.pdf", 23456789, 2, 1700000500});
+    REQUIRE(snap.save(path));
+
+    UsageSnapshot loaded;
+    REQUIRE(loaded.load(path));
+    REQUIRE(loaded.data_directory == "/data/levin");
+    REQUIRE(loaded.usage == 123456789);
+    REQUIRE(loaded.file_count == 42);
+    REQUIRE(loaded.entries.size() == 2);
+    REQUIRE(loaded.entries[0].name == "Some Torrent");
+    REQUIRE(loaded.entries[0].usage == 100000000);
+    REQUIRE(loaded.entries[0].file_count == 40);
+    REQUIRE(loaded.entries[1].newest_mtime == 1700000500);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Missing usage snapshot fails to load", "[snapshot]") {
+    UsageSnapshot snap;
+    REQUIRE_FALSE(snap.load(temp_path("does_not_exist.snap")));
+}
+
+TEST_CASE("Truncated usage snapshot is rejected", "[snapshot]") {
+    std::string path = temp_path("truncated.snap");
+    UsageSnapshot snap;
+    snap.data_directory = "/data";
+    snap.usage = 1;
+    snap.entries.push_back({"entry", 1, 1, 1});
+    REQUIRE(snap.save(path));
+    fs::resize_file(path, fs::file_size(path) - 3);
+
+    UsageSnapshot loaded;
+    loaded.usage = 77;
+    REQUIRE_FALSE(loaded.load(path));
+    REQUIRE(loaded.usage == 77);  // untouched on failure
+
+    std::remove(path.c_str());
+}
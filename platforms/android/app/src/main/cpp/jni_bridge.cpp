@@ -47,6 +47,10 @@ Java_com_yoavmoshe_levin_LevinNative_create(
     config.max_download_kbps = static_cast<int>(maxDownloadKbps);
     config.max_upload_kbps = static_cast<int>(maxUploadKbps);
     config.stun_server = "stun.l.google.com:19302";
+    config.pause_grace_secs = 120;  // ride out Wi-Fi handovers and brief unplugs
+    config.state_debounce_secs = 5;
+    config.state_min_dwell_secs = 15;
+    config.eviction_cooldown_secs = 1800;
 
     levin_t* ctx = levin_create(&config);
     if (!ctx) {
@@ -1,4 +1,5 @@
 #include "config.h"
+#include "io_profile.h"
 
 #include <algorithm>
 #include <cctype>
@@ -137,6 +138,17 @@ std::string default_config_path() {
     return "/etc/levin/levin.toml";
 }
 
+levin_io_profile_t to_c_io_profile(IoProfile profile) {
+    switch (profile) {
+        case IoProfile::SD:   return LEVIN_IO_PROFILE_SD;
+        case IoProfile::SSD:  return LEVIN_IO_PROFILE_SSD;
+        case IoProfile::HDD:  return LEVIN_IO_PROFILE_HDD;
+        case IoProfile::NVME: return LEVIN_IO_PROFILE_NVME;
+        case IoProfile::AUTO: break;
+    }
+    return LEVIN_IO_PROFILE_AUTO;
+}
+
 } // anonymous namespace
 
 // ---------------------------------------------------------------------------
@@ -164,6 +176,15 @@ ShellConfig load_config(const std::string& config_path) {
     cfg.lib_config.disk_check_interval_secs = 60;
     cfg.lib_config.max_download_kbps       = 0;
     cfg.lib_config.max_upload_kbps         = 0;
+    cfg.lib_config.file_selection          = LEVIN_FILE_SELECTION_RANDOM;
+    cfg.lib_config.io_profile              = LEVIN_IO_PROFILE_AUTO;
+    cfg.lib_config.memory_budget_bytes     = 0;
+    cfg.lib_config.unload_inactive         = 0;
+    cfg.lib_config.pause_grace_secs        = 120;
+    cfg.lib_config.state_debounce_secs     = 5;
+    cfg.lib_config.state_min_dwell_secs    = 15;
+    cfg.lib_config.track_data_directory    = 1;
+    cfg.lib_config.eviction_cooldown_secs  = 1800;
 
     // Open config file
     std::string path = config_path.empty() ? default_config_path() : config_path;
@@ -213,6 +234,28 @@ ShellConfig load_config(const std::string& config_path) {
             cfg.lib_config.max_download_kbps = std::stoi(value);
         } else if (key == "max_upload_kbps") {
             cfg.lib_config.max_upload_kbps = std::stoi(value);
+        } else if (key == "file_selection") {
+            std::string v = to_lower(unquote(value));
+            cfg.lib_config.file_selection = (v == "rarest" || v == "rarest_first")
+                ? LEVIN_FILE_SELECTION_RAREST_FIRST : LEVIN_FILE_SELECTION_RANDOM;
+        } else if (key == "unload_inactive") {
+            std::string v = to_lower(value);
+            cfg.lib_config.unload_inactive = (v == "true" || v == "1") ? 1 : 0;
+        } else if (key == "pause_grace_secs") {
+            cfg.lib_config.pause_grace_secs = std::stoi(value);
+        } else if (key == "track_data_directory") {
+            std::string v = to_lower(value);
+            cfg.lib_config.track_data_directory = (v == "true" || v == "1") ? 1 : 0;
+        } else if (key == "state_debounce_secs") {
+            cfg.lib_config.state_debounce_secs = std::stoi(value);
+        } else if (key == "state_min_dwell_secs") {
+            cfg.lib_config.state_min_dwell_secs = std::stoi(value);
+        } else if (key == "eviction_cooldown_secs") {
+            cfg.lib_config.eviction_cooldown_secs = std::stoi(value);
+        } else if (key == "memory_budget_bytes") {
+            cfg.lib_config.memory_budget_bytes = parse_byte_size(unquote(value));
+        } else if (key == "io_profile") {
+            cfg.lib_config.io_profile = to_c_io_profile(parse_io_profile(to_lower(unquote(value))));
         } else if (key == "stun_server") {
             cfg.stun = unquote(value);
         } else if (key == "log_level") {
@@ -132,6 +132,15 @@ static levin::linux_shell::Message handle_ipc(
         reply["disk_budget"]      = std::to_string(st.disk_budget);
         reply["over_budget"]      = std::to_string(st.over_budget);
         reply["file_count"]       = std::to_string(st.file_count);
+        reply["startup_pending"]  = std::to_string(st.startup_pending);
+        reply["startup_total"]    = std::to_string(st.startup_total);
+        reply["memory_budget"]    = std::to_string(st.memory_budget);
+        reply["memory_estimate"]  = std::to_string(st.memory_estimate);
+        reply["soft_paused"]      = std::to_string(st.soft_paused);
+        reply["suppressed_transitions"] = std::to_string(st.suppressed_transitions);
+        reply["eviction_pending"] = std::to_string(st.eviction_pending);
+        reply["wasted_bytes"]     = std::to_string(st.wasted_bytes);
+        reply["eviction_cooldown_secs"] = std::to_string(st.eviction_cooldown_secs);
         return reply;
     }
 
@@ -315,7 +324,8 @@ static int cmd_status() {
         return it != reply.end() ? it->second : "";
     };
 
-    std::printf("State:       %s\n", get("state").c_str());
+    std::printf("State:       %s%s\n", get("state").c_str(),
+                get("soft_paused") == "1" ? " (peers kept connected)" : "");
     std::printf("Torrents:    %s\n", get("torrent_count").c_str());
     std::printf("Books:       %s\n", format_number(get("file_count")).c_str());
     std::printf("Peers:       %s\n", get("peer_count").c_str());
@@ -335,8 +345,34 @@ static int cmd_status() {
     std::printf("Disk budget: %s\n",
                 format_bytes(std::strtoull(get("disk_budget").c_str(),
                                            nullptr, 10)).c_str());
-    std::printf("Over budget: %s\n",
-                get("over_budget") == "1" ? "yes" : "no");
+    uint64_t evicting = std::strtoull(get("eviction_pending").c_str(), nullptr, 10);
+    if (evicting > 0) {
+        std::printf("Over budget: yes (freeing %s)\n", format_bytes(evicting).c_str());
+    } else {
+        std::printf("Over budget: %s\n",
+                    get("over_budget") == "1" ? "yes" : "no");
+    }
+    int cooldown = std::atoi(get("eviction_cooldown_secs").c_str());
+    if (cooldown > 0) {
+        std::printf("Cooldown:    %d min left after evicting\n", (cooldown + 59) / 60);
+    }
+    uint64_t wasted = std::strtoull(get("wasted_bytes").c_str(), nullptr, 10);
+    if (wasted > 0) {
+        std::printf("Wasted:      %s (evicted before upload)\n", format_bytes(wasted).c_str());
+    }
+    if (std::atoi(get("startup_pending").c_str()) > 0) {
+        int total = std::atoi(get("startup_total").c_str());
+        int pending = std::atoi(get("startup_pending").c_str());
+        std::printf("Loading:     %d/%d torrents\n", total - pending, total);
+    }
+    uint64_t mem_budget = std::strtoull(get("memory_budget").c_str(), nullptr, 10);
+    uint64_t mem_estimate = std::strtoull(get("memory_estimate").c_str(), nullptr, 10);
+    if (mem_budget > 0) {
+        std::printf("Memory:      ~%s of %s\n",
+                    format_bytes(mem_estimate).c_str(), format_bytes(mem_budget).c_str());
+    } else {
+        std::printf("Memory:      ~%s\n", format_bytes(mem_estimate).c_str());
+    }
     return 0;
 }
 